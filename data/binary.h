@@ -0,0 +1,72 @@
+#ifndef TINYGRAPH_BINARY_H
+#define TINYGRAPH_BINARY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    // Raw host-order reading and writing for the save/load formats. Every read error
+    // throws std::runtime_error starting with `what`, the format's name. Sizes come
+    // from the file, so arrays are read a bounded chunk at a time: a corrupt size runs
+    // into the end of the input before it can allocate much more than the input holds.
+    namespace detail {
+        constexpr std::size_t read_chunk = 1 << 20;
+
+        template<typename T>
+        void write(std::ostream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        void write(std::ostream& out, const std::vector<T>& values) {
+            write<std::uint64_t>(out, values.size());
+            out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+
+        inline void write(std::ostream& out, const std::string& value) {
+            write<std::uint64_t>(out, value.size());
+            out.write(value.data(), value.size());
+        }
+
+        template<typename T>
+        T read(std::istream& in, const char* what) {
+            T value;
+            if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) throw std::runtime_error(std::string(what) + ": truncated input");
+            return value;
+        }
+
+        // `count` items of T, without reading a size first.
+        template<typename T>
+        std::vector<T> read_items(std::istream& in, std::uint64_t count, const char* what) {
+            std::vector<T> values;
+            while (values.size() < count) {
+                auto first = values.size();
+                auto chunk = std::min<std::uint64_t>(count - first, std::max<std::size_t>(1, read_chunk / sizeof(T)));
+                values.resize(first + chunk);
+                if (!in.read(reinterpret_cast<char*>(values.data() + first), chunk * sizeof(T))) {
+                    throw std::runtime_error(std::string(what) + ": truncated input");
+                }
+            }
+            return values;
+        }
+
+        template<typename T>
+        std::vector<T> read_vector(std::istream& in, std::uint64_t expected, const char* what) {
+            if (read<std::uint64_t>(in, what) != expected) throw std::runtime_error(std::string(what) + ": inconsistent array size");
+            return read_items<T>(in, expected, what);
+        }
+
+        inline std::string read_string(std::istream& in, const char* what) {
+            auto chars = read_items<char>(in, read<std::uint64_t>(in, what), what);
+            return std::string(chars.begin(), chars.end());
+        }
+    }
+}
+
+#endif //TINYGRAPH_BINARY_H
@@ -0,0 +1,125 @@
+#include "builder.h"
+#include <functions/parallel.h>
+#include <generators/data.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace tinygraph {
+    GraphBuilder::GraphBuilder(std::size_t shards) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(shards, 1); i++) this->shards.push_back(std::make_unique<Shard>());
+    }
+
+    GraphBuilder::Shard& GraphBuilder::shard_of(const std::string& name) const {
+        return *this->shards[std::hash<std::string>()(name) % this->shards.size()];
+    }
+
+    std::mutex& GraphBuilder::lock_of(const Vertex* vertex) {
+        // vertices are heap allocated and at least 16 byte aligned, the low bits carry nothing
+        return this->edge_locks[(reinterpret_cast<std::uintptr_t>(vertex) >> 4) % this->edge_locks.size()];
+    }
+
+    std::shared_ptr<Vertex> GraphBuilder::add(const std::string& name, std::shared_ptr<Type> type) {
+        auto& shard = shard_of(name);
+
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.vertices.find(name);
+            if (it != shard.vertices.end()) return it->second;
+        }
+
+        // allocate outside the exclusive lock, the loser of a race throws its copy away
+        auto vertex = vertex_create(name, std::move(type));
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.vertices.emplace(name, std::move(vertex)).first->second;
+    }
+
+    std::shared_ptr<Vertex> GraphBuilder::get_vertex(const std::string& name) const {
+        auto& shard = shard_of(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        auto it = shard.vertices.find(name);
+        return it == shard.vertices.end() ? nullptr : it->second;
+    }
+
+    std::shared_ptr<std::map<std::string, std::any>> GraphBuilder::link(const std::string& from, const std::string& to, bool unidirectional) {
+        auto source = get_vertex(from);
+        auto target = get_vertex(to);
+        if (!source || !target) return nullptr;
+
+        auto to_edge = std::make_shared<Edge>(target);
+        to_edge->properties = std::make_shared<std::map<std::string, std::any>>();
+        {
+            std::lock_guard<std::mutex> lock(lock_of(source.get()));
+            source->connect(to_edge);
+        }
+        {
+            std::lock_guard<std::mutex> lock(lock_of(target.get()));
+            target->in_edges++;
+        }
+
+        if (unidirectional) {
+            auto from_edge = std::make_shared<Edge>(source);
+            from_edge->properties = to_edge->properties;
+            from_edge->reverse = to_edge;
+            to_edge->reverse = from_edge;
+
+            {
+                std::lock_guard<std::mutex> lock(lock_of(target.get()));
+                target->connect(from_edge);
+            }
+            std::lock_guard<std::mutex> lock(lock_of(source.get()));
+            source->in_edges++;
+        }
+
+        return to_edge->properties;
+    }
+
+    std::size_t GraphBuilder::size() const {
+        std::size_t res = 0;
+        for (auto& shard : this->shards) {
+            std::shared_lock<std::shared_mutex> lock(shard->mutex);
+            res += shard->vertices.size();
+        }
+        return res;
+    }
+
+    std::unique_ptr<Graph> GraphBuilder::seal() {
+        std::vector<std::shared_ptr<Vertex>> all;
+        all.reserve(size());
+        for (auto& shard : this->shards) {
+            for (auto& [name, vertex] : shard->vertices) all.push_back(std::move(vertex));
+            shard->vertices.clear();
+        }
+
+        // sort each shard-sized run in parallel, then merge, so that the map below is
+        // filled in key order and every insertion is constant time
+        auto by_name = [](const std::shared_ptr<Vertex>& a, const std::shared_ptr<Vertex>& b) { return a->name < b->name; };
+        std::size_t run = std::max<std::size_t>(4096, all.size() / (default_pool().size() + 1) + 1);
+        parallel_for(0, (all.size() + run - 1) / run, [&](std::size_t lo, std::size_t hi) {
+            for (auto i = lo; i < hi; i++) {
+                std::sort(all.begin() + i * run, all.begin() + std::min(all.size(), (i + 1) * run), by_name);
+            }
+        }, 1);
+        for (std::size_t width = run; width < all.size(); width *= 2) {
+            for (std::size_t lo = 0; lo + width < all.size(); lo += 2 * width) {
+                std::inplace_merge(all.begin() + lo, all.begin() + lo + width, all.begin() + std::min(all.size(), lo + 2 * width), by_name);
+            }
+        }
+
+        auto graph = std::make_unique<Graph>();
+        for (auto& vertex : all) {
+            vertex->add_observer(&graph->indexes);
+            if (vertex->type_id != Type::unregistered) {
+                if (vertex->type_id >= graph->typed_vertices.size()) graph->typed_vertices.resize(vertex->type_id + 1);
+                graph->typed_vertices[vertex->type_id].push_back(vertex);
+            }
+            graph->stored_edges += vertex->connections.size();
+            graph->vertices.emplace_hint(graph->vertices.end(), vertex->name, std::move(vertex));
+        }
+
+        return graph;
+    }
+}
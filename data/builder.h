@@ -0,0 +1,62 @@
+#ifndef TINYGRAPH_BUILDER_H
+#define TINYGRAPH_BUILDER_H
+
+#include "graph.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tinygraph {
+    // Builds a Graph from many threads at once. Names are spread over independently
+    // locked shards and each vertex's edge list is guarded by one of a fixed set of
+    // striped locks, so threads only contend when they touch the same shard or append
+    // to vertices sharing a stripe. seal() hands the result over as a normal Graph;
+    // the builder is empty afterwards.
+    //
+    // add, link and get_vertex may be called concurrently. Properties of a vertex or of
+    // an edge returned by link are not synchronized: only one thread should write them
+    // before seal().
+    class GraphBuilder {
+    public:
+        explicit GraphBuilder(std::size_t shards = 64);
+
+        GraphBuilder(const GraphBuilder&) = delete;
+        GraphBuilder& operator=(const GraphBuilder&) = delete;
+
+        // Unlike Graph::add, an existing vertex is kept: whichever thread adds a name
+        // first wins and every caller gets that vertex back.
+        std::shared_ptr<Vertex> add(const std::string& name, std::shared_ptr<Type> type);
+
+        // nullptr if there is no such vertex yet.
+        std::shared_ptr<Vertex> get_vertex(const std::string& name) const;
+
+        // Same as Graph::link; returns nullptr (and links nothing) if either vertex
+        // does not exist.
+        std::shared_ptr<std::map<std::string, std::any>> link(const std::string& from, const std::string& to, bool unidirectional);
+
+        std::size_t size() const;
+
+        // Must not run concurrently with anything else on the builder.
+        std::unique_ptr<Graph> seal();
+
+    private:
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<std::string, std::shared_ptr<Vertex>> vertices;
+        };
+
+        Shard& shard_of(const std::string& name) const;
+
+        // guards the vertex's connections, edges_to and in_edges
+        std::mutex& lock_of(const Vertex* vertex);
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::array<std::mutex, 1024> edge_locks;
+    };
+}
+
+#endif //TINYGRAPH_BUILDER_H
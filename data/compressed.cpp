@@ -0,0 +1,156 @@
+#include "compressed.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace tinygraph {
+    namespace {
+        void encode(std::vector<std::uint8_t>& bytes, std::uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        std::uint64_t zigzag(std::int64_t value) {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        std::int64_t unzigzag(std::uint64_t value) {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+    }
+
+    CompressedAdjacency::Builder::Builder(bool weighted) : byte_offsets{0}, edge_offsets{0}, weight_width(weighted ? 1 : 0) { }
+
+    void CompressedAdjacency::Builder::add(std::string name, std::vector<Arc> arcs) {
+        auto vertex = names.size();
+        names.push_back(std::move(name));
+
+        std::stable_sort(arcs.begin(), arcs.end(), [](const Arc& a, const Arc& b) { return a.to < b.to; });
+
+        auto position = edge_offsets.back();
+        for (std::size_t i = 0; i < arcs.size(); i++, position++) {
+            if (i == 0) {
+                encode(bytes, zigzag(static_cast<std::int64_t>(arcs[i].to) - static_cast<std::int64_t>(vertex)));
+            } else {
+                encode(bytes, arcs[i].to - arcs[i - 1].to);
+            }
+            if (weight_width != 0) add_weight(arcs[i].weight);
+
+            // until the first arc out of place every id is its position
+            if (!moved && arcs[i].edge != position) {
+                moved = true;
+                edges.resize(position);
+                std::iota(edges.begin(), edges.end(), std::uint64_t(0));
+            }
+            if (moved) edges.push_back(arcs[i].edge);
+        }
+
+        byte_offsets.push_back(bytes.size());
+        edge_offsets.push_back(position);
+    }
+
+    void CompressedAdjacency::Builder::add_weight(double weight) {
+        if (weight_width == 8) {
+            weight_values.push_back(weight);
+            return;
+        }
+
+        // by bit pattern, so that every weight comes back exactly as it went in
+        std::uint64_t bits;
+        std::memcpy(&bits, &weight, sizeof(bits));
+        auto code = codes.emplace(bits, static_cast<std::uint32_t>(codes.size())).first->second;
+        if (code == weight_values.size()) weight_values.push_back(weight);
+
+        if (code == (1 << 16)) {
+            // too many distinct weights: every edge keeps its own
+            std::vector<double> raw;
+            raw.reserve(weight_codes.size() / 2 + 1);
+            for (std::size_t p = 0; p < weight_codes.size(); p += 2) {
+                raw.push_back(weight_values[weight_codes[p] | (weight_codes[p + 1] << 8)]);
+            }
+            raw.push_back(weight);
+
+            weight_values = std::move(raw);
+            weight_codes = {};
+            codes = {};
+            weight_width = 8;
+            return;
+        }
+
+        if (code == (1 << 8) && weight_width == 1) {
+            // from one byte codes to two, in place from the back
+            auto count = weight_codes.size();
+            weight_codes.resize(2 * count);
+            for (auto p = count; p-- > 0;) {
+                auto low = weight_codes[p];
+                weight_codes[2 * p] = low;
+                weight_codes[2 * p + 1] = 0;
+            }
+            weight_width = 2;
+        }
+
+        weight_codes.push_back(static_cast<std::uint8_t>(code));
+        if (weight_width == 2) weight_codes.push_back(static_cast<std::uint8_t>(code >> 8));
+    }
+
+    CompressedAdjacency CompressedAdjacency::Builder::build() {
+        CompressedAdjacency res;
+        res.names = std::move(names);
+        res.byte_offsets = std::move(byte_offsets);
+        res.edge_offsets = std::move(edge_offsets);
+        res.bytes = std::move(bytes);
+        res.bytes.shrink_to_fit();
+        if (moved) res.edge_ids = std::move(edges);
+
+        res.weight_width = weight_width;
+        res.weight_values = std::move(weight_values);
+        res.weight_values.shrink_to_fit();
+        res.weight_codes = std::move(weight_codes);
+        res.weight_codes.shrink_to_fit();
+        return res;
+    }
+
+    CompressedAdjacency::CompressedAdjacency(const Snapshot& snapshot) {
+        Builder builder(!snapshot.weights.empty());
+
+        std::vector<Arc> arcs;
+        for (std::size_t v = 0; v < snapshot.size(); v++) {
+            arcs.clear();
+            for (auto arc : snapshot.neighbours(v)) arcs.push_back(arc);
+            builder.add(snapshot.names[v], arcs);
+        }
+
+        *this = builder.build();
+    }
+
+    CompressedAdjacency::ArcIterator::ArcIterator(const CompressedAdjacency* adjacency, std::size_t vertex, std::size_t edge, std::size_t last)
+            : adjacency(adjacency), position(adjacency->bytes.data() + adjacency->byte_offsets[vertex]), edge(edge), last(last) {
+        if (edge < last) current = static_cast<std::size_t>(static_cast<std::int64_t>(vertex) + unzigzag(decode()));
+    }
+
+    CompressedAdjacency::Arcs CompressedAdjacency::neighbours(std::size_t vertex) const {
+        auto first = edge_offsets[vertex];
+        auto last = edge_offsets[vertex + 1];
+        return {ArcIterator(this, vertex, first, last), ArcIterator(this, vertex, last, last)};
+    }
+
+    std::size_t CompressedAdjacency::size() const {
+        return names.size();
+    }
+
+    std::size_t CompressedAdjacency::degree(std::size_t vertex) const {
+        return edge_offsets[vertex + 1] - edge_offsets[vertex];
+    }
+
+    std::size_t CompressedAdjacency::edge_count() const {
+        return edge_offsets.back();
+    }
+
+    std::size_t CompressedAdjacency::memory_bytes() const {
+        return byte_offsets.size() * sizeof(std::uint64_t) + edge_offsets.size() * sizeof(std::uint64_t) + bytes.size() +
+               weight_values.size() * sizeof(double) + weight_codes.size() + edge_ids.size() * sizeof(std::uint64_t);
+    }
+}
@@ -11,14 +11,62 @@
 #include <algorithm>
 #include "graph.h"
 #include <variant>
+#include <limits>
 
 namespace tinygraph {
     Graph::Graph() = default;
 
-    Graph::~Graph() = default;
+    Graph::~Graph() {
+        for (auto& [name, vertex] : this->vertices) {
+            vertex->remove_observer(&this->indexes);
+        }
+    }
 
     void Graph::add_vertex(std::shared_ptr<Vertex> vertex) {
-        this->vertices[vertex->name] = std::move(vertex);
+        auto& slot = this->vertices[vertex->name];
+
+        if (slot) {
+            this->indexes.vertex_removed(*slot);
+            slot->remove_observer(&this->indexes);
+
+            // the replaced vertex's list leaves the graph with it, dead edges included
+            for (auto& edge : slot->connections) {
+                if (!edge->live() && this->dead_edges > 0) this->dead_edges--;
+            }
+            this->stored_edges -= std::min(this->stored_edges, slot->connections.size());
+        }
+
+        vertex->add_observer(&this->indexes);
+        this->indexes.vertex_added(*vertex);
+
+        if (slot && slot->type_id < this->typed_vertices.size()) {
+            // `vertices` is public, so the old vertex need not have come through here
+            auto& same_type = this->typed_vertices[slot->type_id];
+            auto it = std::find(same_type.begin(), same_type.end(), slot);
+            if (it != same_type.end()) same_type.erase(it);
+        }
+        if (vertex->type_id != Type::unregistered) {
+            if (vertex->type_id >= this->typed_vertices.size()) this->typed_vertices.resize(vertex->type_id + 1);
+            this->typed_vertices[vertex->type_id].push_back(vertex);
+        }
+
+        this->stored_edges += vertex->connections.size();
+        slot = std::move(vertex);
+    }
+
+    const std::vector<std::shared_ptr<Vertex>>& Graph::vertices_of(const std::shared_ptr<Type>& type) {
+        static const std::vector<std::shared_ptr<Vertex>> none;
+
+        if (!type || type->id >= this->typed_vertices.size()) return none;
+
+        auto& same_type = this->typed_vertices[type->id];
+        if (type->id < this->typed_removed.size() && this->typed_removed[type->id] > 0) {
+            same_type.erase(std::remove_if(same_type.begin(), same_type.end(), [](const std::shared_ptr<Vertex>& vertex) {
+                return vertex->removed;
+            }), same_type.end());
+            this->typed_removed[type->id] = 0;
+        }
+        return same_type;
     }
 
     std::shared_ptr<Vertex> Graph::get_vertex(const std::string& name) {
@@ -27,9 +75,137 @@ namespace tinygraph {
     }
 
     std::shared_ptr<std::map<std::string, std::any>> Graph::link(const std::string& from, const std::string& to, bool unidirectional) {
+        this->stored_edges += unidirectional ? 2 : 1;
         return vertex_link(this->vertices[from], this->vertices[to], unidirectional);
     }
 
+    namespace {
+        std::size_t tombstone(Edge& edge) {
+            std::size_t res = 0;
+            if (!edge.removed) {
+                edge.removed = true;
+                edge.to->in_edges--;
+                res++;
+            }
+
+            auto reverse = edge.reverse.lock();
+            if (reverse && !reverse->removed) {
+                reverse->removed = true;
+                reverse->to->in_edges--;
+                res++;
+            }
+            return res;
+        }
+    }
+
+    bool Graph::remove_edge(const std::string& from, const std::string& to) {
+        auto source = this->vertices.find(from);
+        auto target = this->vertices.find(to);
+        if (source == this->vertices.end() || target == this->vertices.end()) return false;
+
+        bool found = false;
+        for (auto edge : source->second->edges_into(target->second.get())) {
+            if (!edge->live()) continue;
+
+            this->dead_edges += tombstone(*edge);
+            found = true;
+        }
+
+        if (found) compact_step();
+        return found;
+    }
+
+    bool Graph::remove_vertex(const std::string& name) {
+        auto it = this->vertices.find(name);
+        if (it == this->vertices.end()) return false;
+
+        auto vertex = std::move(it->second);
+        this->vertices.erase(it);
+
+        this->indexes.vertex_removed(*vertex);
+        vertex->remove_observer(&this->indexes);
+
+        if (vertex->type_id < this->typed_vertices.size()) {
+            if (vertex->type_id >= this->typed_removed.size()) this->typed_removed.resize(vertex->type_id + 1, 0);
+            this->typed_removed[vertex->type_id]++;
+        }
+
+        // the vertex's own list goes right away; the halves of undirected links that
+        // live in the neighbours' lists become tombstones
+        for (auto& edge : vertex->connections) {
+            if (!edge->live()) {
+                if (this->dead_edges > 0) this->dead_edges--;
+                continue;
+            }
+
+            edge->removed = true;
+            edge->to->in_edges--;
+            auto reverse = edge->reverse.lock();
+            if (reverse && !reverse->removed) {
+                reverse->removed = true;
+                reverse->to->in_edges--;
+                this->dead_edges++;
+            }
+        }
+        this->stored_edges -= std::min(this->stored_edges, vertex->connections.size());
+        vertex->connections.clear();
+        vertex->edges_to.clear();
+
+        // what is left are directed edges into the vertex, which die with it
+        this->dead_edges += vertex->in_edges;
+        vertex->in_edges = 0;
+        vertex->removed = true;
+
+        compact_step();
+        return true;
+    }
+
+    void Graph::compact() {
+        std::vector<Vertex*> all;
+        all.reserve(this->vertices.size());
+        for (auto& [name, vertex] : this->vertices) all.push_back(vertex.get());
+
+        std::atomic<std::size_t> stored{0};
+        parallel_for(0, all.size(), [&](std::size_t lo, std::size_t hi) {
+            std::size_t kept = 0;
+            for (auto i = lo; i < hi; i++) {
+                all[i]->drop_dead_edges();
+                kept += all[i]->connections.size();
+            }
+            stored += kept;
+        }, 256);
+
+        this->stored_edges = stored;
+        this->dead_edges = 0;
+        this->compacting = false;
+        this->compaction_cursor.clear();
+    }
+
+    void Graph::compact_step() {
+        if (!this->compacting) {
+            if (this->dead_edges <= this->compaction_threshold * this->stored_edges) return;
+            this->compacting = true;
+            this->compaction_cursor.clear();
+        }
+
+        std::size_t visited = 0;
+        auto it = this->vertices.lower_bound(this->compaction_cursor);
+        for (; it != this->vertices.end() && visited < this->compaction_batch; ++it) {
+            visited += it->second->connections.size() + 1;
+
+            auto dropped = it->second->drop_dead_edges();
+            this->dead_edges -= std::min(this->dead_edges, dropped);
+            this->stored_edges -= std::min(this->stored_edges, dropped);
+        }
+
+        if (it == this->vertices.end()) {
+            this->compacting = false;
+            this->compaction_cursor.clear();
+        } else {
+            this->compaction_cursor = it->first;
+        }
+    }
+
     std::shared_ptr<Vertex> Graph::add(const std::string &name, std::shared_ptr<Type> type) {
         auto v = vertex_create(name, std::move(type));
         this->add_vertex(v);
@@ -37,25 +213,45 @@ namespace tinygraph {
     }
 
     std::string Graph::str() {
-        std::string res;
+        std::ostringstream res;
+        export_graph(*this, res);
+        return res.str();
+    }
 
-        for (const auto& [key, vertex] : this->vertices) {
-            res += key;
+    void Graph::create_index(const std::string& key, IndexKind kind) {
+        this->indexes.create(key, kind, this->vertices);
+    }
 
-            for (const auto& [propKey, property] : vertex->properties) {
-                res += " [" + propKey + " = " + any_to_str(&property) + "]";
-            }
+    bool Graph::drop_index(const std::string& key) {
+        return this->indexes.drop(key);
+    }
 
-            res += "\n";
+    std::vector<std::shared_ptr<Vertex>> Graph::find(const std::string& key, const std::any& value) {
+        if (this->indexes.has(key)) return this->indexes.find(key, value);
 
-            for (const auto& c : vertex->connections) {
-                res += "\t" + key + " -> " + c->to->name;
+        std::vector<std::shared_ptr<Vertex>> res;
+        PropertyIndexes::key_type wanted, actual;
+        if (!PropertyIndexes::index_key(value, wanted)) return res;
 
-                for (const auto& [propKey, property] : *c->properties) {
-                    res += " [" + propKey + " = " + any_to_str(&property) + "]";
-                }
+        for (const auto& [name, vertex] : this->vertices) {
+            auto property = vertex->properties.find(key);
+            if (property == vertex->properties.end()) continue;
 
-                res += "\n";
+            if (PropertyIndexes::index_key(property->second, actual) && actual == wanted) res.push_back(vertex);
+        }
+
+        return res;
+    }
+
+    std::vector<std::shared_ptr<Vertex>> Graph::find_range(const std::string& key, double low, double high) {
+        if (this->indexes.has(key, IndexKind::sorted)) return this->indexes.find_range(key, low, high);
+
+        std::vector<std::shared_ptr<Vertex>> res;
+        for (const auto& [name, vertex] : this->vertices) {
+            auto property = vertex->properties.find(key);
+            double value;
+            if (property != vertex->properties.end() && any_to_double(&property->second, value) && value >= low && value <= high) {
+                res.push_back(vertex);
             }
         }
 
@@ -93,6 +289,8 @@ namespace tinygraph {
             {
             for (auto& edge : vertex_ptr->connections)
             {
+                if (!edge->live()) continue;
+
                 if (edge->properties && edge->properties->find(path_property) != edge->properties->end())
                 {
                     std::any property = edge->properties->at(path_property);
@@ -148,12 +346,37 @@ namespace tinygraph {
         else return std::numeric_limits<int>::min();
     }
 
+    bool Graph::path_allows(const Vertex& vertex) const
+    {
+        return path_types.empty() || (vertex.type_id < path_types.size() && path_types[vertex.type_id]);
+    }
+
     bool Graph::bellman_ford(const std::string& the_source_name, const std::string& sorting_property)
+    {
+        return bellman_ford(the_source_name, sorting_property, {});
+    }
+
+    bool Graph::bellman_ford(const std::string& the_source_name, const std::string& sorting_property, const std::vector<std::shared_ptr<Type>>& only)
+    {
+        return bellman_ford(the_source_name, sorting_property, only, CancellationToken::never());
+    }
+
+    bool Graph::bellman_ford(const std::string& the_source_name, const std::string& sorting_property, const std::vector<std::shared_ptr<Type>>& only, const CancellationToken& token)
     {
         if (sorting_property.empty() || the_source_name.empty()) return false;
         path_property = sorting_property;
         source_name = the_source_name;
-        if (!vertex_exists(the_source_name))
+
+        path_types.clear();
+        for (auto& type : only)
+        {
+            if (!type || type->id == Type::unregistered) continue;
+            if (type->id >= path_types.size()) path_types.resize(type->id + 1, false);
+            path_types[type->id] = true;
+        }
+        if (!only.empty() && path_types.empty()) path_types.push_back(false);
+
+        if (!vertex_exists(the_source_name) || !path_allows(*vertices[the_source_name]))
         {
             reset_paths();
             return false;
@@ -167,10 +390,20 @@ namespace tinygraph {
  
         for (int i=0; i<vertices.size()-1; i++) 
         {
+            if (token.cancelled())
+            {
+                reset_paths();
+                throw Cancelled();
+            }
+
             for (auto& [vertex_name, vertex_ptr] : vertices)
             {
+                if (!path_allows(*vertex_ptr)) continue;
+
                 for (auto& edge : vertex_ptr->connections)
                 {
+                    if (!edge->live() || !path_allows(*edge->to)) continue;
+
                     if (edge->properties && edge->properties->find(sorting_property) != edge->properties->end())
                     {
                         std::any property = edge->properties->at(path_property);
@@ -214,8 +447,12 @@ namespace tinygraph {
 
         for (auto& [vertex_name, vertex_ptr] : vertices)
         {
+            if (!path_allows(*vertex_ptr)) continue;
+
             for (auto& edge : vertex_ptr->connections)
             {
+                if (!edge->live() || !path_allows(*edge->to)) continue;
+
                 if (edge->properties && edge->properties->find(sorting_property) != edge->properties->end())
                 {
                     std::any property = edge->properties->at(path_property);
@@ -288,7 +525,7 @@ namespace tinygraph {
         return shortest_path;
     }
 
-    void Graph::dfs(const std::string& current, const std::string& destination, std::map<std::string, vector<std::string>>& adj, std::map<std::string, bool>& visited, std::vector<std::string>& path, bool& found) 
+    void Graph::dfs(const std::string& current, const std::string& destination, std::map<std::string, std::vector<std::string>>& adj, std::map<std::string, bool>& visited, std::vector<std::string>& path, bool& found) 
     {
         visited[current] = true;
 
@@ -314,7 +551,7 @@ namespace tinygraph {
     {
         if (vertices.find(source) == vertices.end() || vertices.find(destination) == vertices.end()) return false;
 
-        std::map<std::string, vector<std::string>> adj;
+        std::map<std::string, std::vector<std::string>> adj;
         std::map<std::string, bool> visited;
 
         std::vector<std::string> path;
@@ -330,15 +567,8 @@ namespace tinygraph {
         {
             for (auto& edge : vertex_ptr->connections)
             {
-                if (undirected)
-                {
-                    adj[vertex_name].push_back(edge->to->name);
-                    adj[edge->to->name].push_back(vertex_name);
-                }
-                else
-                {
-                    adj[vertex_name].push_back(edge->to->name);
-                }
+                if (!edge->live()) continue;
+                adj[vertex_name].push_back(edge->to->name);
             }
         }
         
@@ -6,6 +6,8 @@
 #define TINYGRAPH_GRAPH_H
 
 #include "types.h"
+#include "index.h"
+#include <functions/cancellation.h>
 #include <vector>
 #include <variant>
 
@@ -17,16 +19,80 @@ namespace tinygraph {
         Graph();
         ~Graph();
 
+        // The property indexes refer to this graph's vertices, so graphs do not copy.
+        Graph(const Graph&) = delete;
+        Graph& operator=(const Graph&) = delete;
+
         std::shared_ptr<Vertex> add(const std::string& name, std::shared_ptr<Type> type);
 
         void add_vertex(std::shared_ptr<Vertex> vertex);
 
         std::shared_ptr<Vertex> get_vertex(const std::string& name);
 
+        // Vertices grouped by Type::id, in insertion order. Vertices of unregistered
+        // types are only in `vertices`.
+        std::vector<std::vector<std::shared_ptr<Vertex>>> typed_vertices;
+
+        // Removed vertices per type id still waiting in typed_vertices; vertices_of drops
+        // them before returning the list.
+        std::vector<std::size_t> typed_removed;
+
+        const std::vector<std::shared_ptr<Vertex>>& vertices_of(const std::shared_ptr<Type>& type);
+
+        PropertyIndexes indexes;
+
+        // Indexes the vertex property `key`; later writes through add_prop or
+        // properties[...] keep the index current.
+        void create_index(const std::string& key, IndexKind kind);
+
+        bool drop_index(const std::string& key);
+
+        // Vertices whose property `key` equals value. Uses the index on key if there is
+        // one and scans all vertices otherwise.
+        std::vector<std::shared_ptr<Vertex>> find(const std::string& key, const std::any& value);
+
+        // Vertices whose numeric property `key` lies in [low, high]. Uses a sorted index on
+        // key if there is one and scans all vertices otherwise.
+        std::vector<std::shared_ptr<Vertex>> find_range(const std::string& key, double low, double high);
+
         std::shared_ptr<std::map<std::string, std::any>> link(const std::string& from, const std::string& to, bool unidirectional);
 
+        // Tombstones every edge from -> to, and the other half of undirected ones. False
+        // if there is no such edge. Scans from's connections while it has few edges and
+        // goes through its edges_to after that, so the cost does not grow with the degree.
+        bool remove_edge(const std::string& from, const std::string& to);
+
+        // Takes the vertex out of `vertices`, the indexes and vertices_of, and
+        // tombstones its edges. Edges into it from other vertices are skipped from now
+        // on; its in_edges count goes to dead_edges, and compaction drops them.
+        bool remove_vertex(const std::string& name);
+
+        // Erases tombstoned edges from every connection list, one batch of vertices per
+        // pool thread, and ends a running sweep.
+        void compact();
+
+        // Once dead_edges passes compaction_threshold of stored_edges, a sweep starts:
+        // every later removal compacts the lists of the next few vertices, about
+        // compaction_batch stored edges, until it has been through all of them. No
+        // removal pays for a whole pass, and removals stay amortized constant time.
+        void compact_step();
+
+        double compaction_threshold = 0.25;
+        std::size_t compaction_batch = 4096;
+
+        // Whether a sweep is running, and the name of the vertex it continues with.
+        bool compacting = false;
+        std::string compaction_cursor;
+
+        // Edges stored in connection lists, live or not, and the dead ones among them:
+        // tombstoned, or into a removed vertex. Both are approximate for edges linked
+        // with vertex_link directly.
+        std::size_t stored_edges = 0;
+        std::size_t dead_edges = 0;
+
         std::vector<std::vector<std::string>> connected_components();
 
+        // The whole graph in ExportFormat::text; use export_graph to stream large graphs.
         std::string str();
 
         using number = std::variant<int, float, double>; // more types can be added here
@@ -38,6 +104,19 @@ namespace tinygraph {
         std::string path_property;
 
         bool bellman_ford(const std::string& the_source_name, const std::string& sorting_property);
+
+        // Same as above, but paths may only pass through vertices of the given types; an
+        // empty list allows every type. Vertices of other types keep an infinite distance.
+        bool bellman_ford(const std::string& the_source_name, const std::string& sorting_property, const std::vector<std::shared_ptr<Type>>& only);
+
+        // Checks the token before every pass; once it is cancelled the paths are reset
+        // and Cancelled is thrown.
+        bool bellman_ford(const std::string& the_source_name, const std::string& sorting_property, const std::vector<std::shared_ptr<Type>>& only, const CancellationToken& token);
+
+        // indexed by Type::id, empty when every type is allowed
+        std::vector<bool> path_types;
+
+        bool path_allows(const Vertex& vertex) const;
         
         bool vertex_exists(const std::string& vertex);
 
@@ -55,7 +134,7 @@ namespace tinygraph {
 
         number find_value(std::any& property);
 
-        void dfs(const std::string& current, const std::string& destination, std::map<std::string, vector<std::string>>& adj, std::map<std::string, bool>& visited, std::vector<std::string>& path); 
+        void dfs(const std::string& current, const std::string& destination, std::map<std::string, std::vector<std::string>>& adj, std::map<std::string, bool>& visited, std::vector<std::string>& path, bool& found);
 
         bool dfsSetup(const std::string& source, const std::string& destination);
 
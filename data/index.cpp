@@ -0,0 +1,137 @@
+#include "index.h"
+#include <functions/util.h>
+#include <limits>
+
+namespace tinygraph {
+    bool PropertyIndexes::index_key(const std::any& value, key_type& out) {
+        double number;
+        if (any_to_double(&value, number)) {
+            if (number != number) return false;
+            out = number;
+        } else if (value.type() == typeid(std::string)) {
+            out = std::any_cast<std::string>(value);
+        } else if (value.type() == typeid(const char*)) {
+            out = std::string(std::any_cast<const char*>(value));
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    void PropertyIndexes::Index::insert(Vertex* vertex, const std::any& value) {
+        key_type key;
+        if (!index_key(value, key)) return;
+
+        if (kind == IndexKind::hash) {
+            hash[key].insert(vertex);
+        } else if (auto number = std::get_if<double>(&key)) {
+            sorted.emplace(*number, vertex);
+        } else {
+            sorted_strings.emplace(std::get<std::string>(key), vertex);
+        }
+    }
+
+    void PropertyIndexes::Index::erase(Vertex* vertex, const std::any& value) {
+        key_type key;
+        if (!index_key(value, key)) return;
+
+        if (kind == IndexKind::hash) {
+            auto it = hash.find(key);
+            if (it == hash.end()) return;
+            it->second.erase(vertex);
+            if (it->second.empty()) hash.erase(it);
+        } else if (auto number = std::get_if<double>(&key)) {
+            sorted.erase({*number, vertex});
+        } else {
+            sorted_strings.erase({std::get<std::string>(key), vertex});
+        }
+    }
+
+    void PropertyIndexes::create(const std::string& key, IndexKind kind, const std::map<std::string, std::shared_ptr<Vertex>>& vertices) {
+        auto& index = indexes[key];
+        index = Index();
+        index.kind = kind;
+
+        for (const auto& [name, vertex] : vertices) {
+            auto property = vertex->properties.find(key);
+            if (property != vertex->properties.end()) index.insert(vertex.get(), property->second);
+        }
+    }
+
+    bool PropertyIndexes::drop(const std::string& key) {
+        return indexes.erase(key) > 0;
+    }
+
+    bool PropertyIndexes::has(const std::string& key) const {
+        return indexes.count(key) > 0;
+    }
+
+    bool PropertyIndexes::has(const std::string& key, IndexKind kind) const {
+        auto it = indexes.find(key);
+        return it != indexes.end() && it->second.kind == kind;
+    }
+
+    std::vector<std::shared_ptr<Vertex>> PropertyIndexes::find(const std::string& key, const std::any& value) const {
+        std::vector<std::shared_ptr<Vertex>> res;
+
+        auto it = indexes.find(key);
+        key_type lookup;
+        if (it == indexes.end() || !index_key(value, lookup)) return res;
+
+        const auto& index = it->second;
+        if (index.kind == IndexKind::hash) {
+            auto bucket = index.hash.find(lookup);
+            if (bucket == index.hash.end()) return res;
+
+            res.reserve(bucket->second.size());
+            for (auto vertex : bucket->second) res.push_back(vertex->shared_from_this());
+        } else if (auto number = std::get_if<double>(&lookup)) {
+            for (auto e = index.sorted.lower_bound({*number, nullptr}); e != index.sorted.end() && e->first == *number; ++e) {
+                res.push_back(e->second->shared_from_this());
+            }
+        } else {
+            const auto& text = std::get<std::string>(lookup);
+            for (auto e = index.sorted_strings.lower_bound({text, nullptr}); e != index.sorted_strings.end() && e->first == text; ++e) {
+                res.push_back(e->second->shared_from_this());
+            }
+        }
+
+        return res;
+    }
+
+    std::vector<std::shared_ptr<Vertex>> PropertyIndexes::find_range(const std::string& key, double low, double high) const {
+        std::vector<std::shared_ptr<Vertex>> res;
+
+        auto it = indexes.find(key);
+        if (it == indexes.end() || it->second.kind != IndexKind::sorted) return res;
+
+        const auto& sorted = it->second.sorted;
+        for (auto e = sorted.lower_bound({low, nullptr}); e != sorted.end() && e->first <= high; ++e) {
+            res.push_back(e->second->shared_from_this());
+        }
+
+        return res;
+    }
+
+    void PropertyIndexes::vertex_added(Vertex& vertex) {
+        for (auto& [key, index] : indexes) {
+            auto property = vertex.properties.find(key);
+            if (property != vertex.properties.end()) index.insert(&vertex, property->second);
+        }
+    }
+
+    void PropertyIndexes::vertex_removed(Vertex& vertex) {
+        for (auto& [key, index] : indexes) {
+            auto property = vertex.properties.find(key);
+            if (property != vertex.properties.end()) index.erase(&vertex, property->second);
+        }
+    }
+
+    void PropertyIndexes::property_changed(Vertex& vertex, const std::string& key, const std::any* before, const std::any* after) {
+        auto it = indexes.find(key);
+        if (it == indexes.end()) return;
+
+        if (before) it->second.erase(&vertex, *before);
+        if (after) it->second.insert(&vertex, *after);
+    }
+}
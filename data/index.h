@@ -0,0 +1,59 @@
+#ifndef TINYGRAPH_INDEX_H
+#define TINYGRAPH_INDEX_H
+
+#include "types.h"
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+
+namespace tinygraph {
+    // hash answers equality lookups, sorted answers equality and numeric range lookups.
+    enum class IndexKind { hash, sorted };
+
+    // Secondary indexes over vertex properties, kept current through the
+    // PropertyObserver hook. Numbers (int, float, double) are indexed by value, so 3
+    // and 3.0 are equal; strings and const char* are indexed as strings. Values of
+    // any other type are not indexed.
+    class PropertyIndexes : public PropertyObserver {
+    public:
+        using key_type = std::variant<double, std::string>;
+
+        void create(const std::string& key, IndexKind kind, const std::map<std::string, std::shared_ptr<Vertex>>& vertices);
+
+        bool drop(const std::string& key);
+
+        bool has(const std::string& key) const;
+
+        bool has(const std::string& key, IndexKind kind) const;
+
+        std::vector<std::shared_ptr<Vertex>> find(const std::string& key, const std::any& value) const;
+
+        // Vertices whose numeric property lies in [low, high].
+        std::vector<std::shared_ptr<Vertex>> find_range(const std::string& key, double low, double high) const;
+
+        void vertex_added(Vertex& vertex);
+
+        void vertex_removed(Vertex& vertex);
+
+        void property_changed(Vertex& vertex, const std::string& key, const std::any* before, const std::any* after) override;
+
+        static bool index_key(const std::any& value, key_type& out);
+
+    private:
+        struct Index {
+            IndexKind kind;
+            std::unordered_map<key_type, std::unordered_set<Vertex*>> hash;
+            std::set<std::pair<double, Vertex*>> sorted;
+            std::set<std::pair<std::string, Vertex*>> sorted_strings;
+
+            void insert(Vertex* vertex, const std::any& value);
+            void erase(Vertex* vertex, const std::any& value);
+        };
+
+        std::unordered_map<std::string, Index> indexes;
+    };
+}
+
+#endif //TINYGRAPH_INDEX_H
@@ -0,0 +1,129 @@
+#ifndef TINYGRAPH_PERSISTENT_H
+#define TINYGRAPH_PERSISTENT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tinygraph {
+    // Append-only sequence whose copies share their items. A copy is a pointer and a
+    // length; push_back writes into the shared buffer when no other copy has appended
+    // past this one yet, and into a fresh buffer of twice the size otherwise, so
+    // appending is amortized constant time and never changes what another copy sees.
+    //
+    // Copies may be read from any thread, but all appends to copies of one log must be
+    // serialized by the caller.
+    template<typename T>
+    class SharedLog {
+    public:
+        std::size_t size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        const T& operator[](std::size_t i) const { return buffer->items[i]; }
+
+        void push_back(T item) {
+            if (!buffer || buffer->used != count || count == buffer->capacity) {
+                auto grown = std::make_shared<Buffer>(std::max<std::size_t>(4, 2 * count));
+                std::copy(buffer ? buffer->items.get() : nullptr, buffer ? buffer->items.get() + count : nullptr, grown->items.get());
+                buffer = std::move(grown);
+            }
+
+            buffer->items[count] = std::move(item);
+            buffer->used = ++count;
+        }
+
+    private:
+        struct Buffer {
+            explicit Buffer(std::size_t capacity) : items(new T[capacity]), capacity(capacity) { }
+
+            std::unique_ptr<T[]> items;
+            std::size_t capacity;
+            // length of the longest copy, the only one that may append in place
+            std::size_t used = 0;
+        };
+
+        std::shared_ptr<Buffer> buffer;
+        std::size_t count = 0;
+    };
+
+    // Immutable hash map: set() copies only the path from the root to the changed
+    // entry, 32 children per level, and every other node stays shared with the copies
+    // made before. Lookups and updates take O(log32 n) steps.
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class PersistentMap {
+    public:
+        std::size_t size() const { return count; }
+
+        // nullptr if the key is not in the map
+        const Value* find(const Key& key) const {
+            auto hash = Hash{}(key);
+            const Node* node = root.get();
+            for (unsigned shift = 0; node && !node->children.empty(); shift += bits) {
+                node = node->children[(hash >> shift) & (fanout - 1)].get();
+            }
+            if (!node) return nullptr;
+
+            for (const auto& entry : node->entries) {
+                if (entry.first == key) return &entry.second;
+            }
+            return nullptr;
+        }
+
+        void set(const Key& key, Value value) {
+            bool added = false;
+            root = insert(root, Hash{}(key), 0, key, std::move(value), added);
+            if (added) count++;
+        }
+
+    private:
+        static constexpr unsigned bits = 5;
+        static constexpr std::size_t fanout = std::size_t(1) << bits;
+        static constexpr std::size_t leaf_size = 8;
+
+        // Either `fanout` children, or a leaf of entries whose hashes agree up to here.
+        struct Node {
+            std::vector<std::shared_ptr<const Node>> children;
+            std::vector<std::pair<Key, Value>> entries;
+        };
+
+        static std::shared_ptr<const Node> insert(const std::shared_ptr<const Node>& node, std::size_t hash, unsigned shift, const Key& key, Value value, bool& added) {
+            auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+
+            if (!copy->children.empty()) {
+                auto& child = copy->children[(hash >> shift) & (fanout - 1)];
+                child = insert(child, hash, shift + bits, key, std::move(value), added);
+                return copy;
+            }
+
+            for (auto& entry : copy->entries) {
+                if (entry.first == key) {
+                    entry.second = std::move(value);
+                    return copy;
+                }
+            }
+
+            added = true;
+            copy->entries.emplace_back(key, std::move(value));
+            if (copy->entries.size() <= leaf_size || shift + bits >= 8 * sizeof(std::size_t)) return copy;
+
+            auto split = std::make_shared<Node>();
+            split->children.resize(fanout);
+            for (auto& entry : copy->entries) {
+                auto entry_hash = Hash{}(entry.first);
+                auto& child = split->children[(entry_hash >> shift) & (fanout - 1)];
+                bool ignored = false;
+                child = insert(child, entry_hash, shift + bits, entry.first, std::move(entry.second), ignored);
+            }
+            return split;
+        }
+
+        std::shared_ptr<const Node> root;
+        std::size_t count = 0;
+    };
+}
+
+#endif //TINYGRAPH_PERSISTENT_H
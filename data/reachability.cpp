@@ -0,0 +1,275 @@
+#include "reachability.h"
+#include "binary.h"
+#include <functions/components.h>
+#include <algorithm>
+#include <chrono>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+
+namespace tinygraph {
+    namespace {
+        constexpr char magic[4] = {'T', 'G', 'R', 'I'};
+        constexpr std::uint32_t format_version = 1;
+
+        constexpr char what[] = "reachability index";
+
+        double seconds_since(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    ReachabilityIndex::ReachabilityIndex(const Snapshot& snapshot, std::size_t traversals) {
+        auto start = std::chrono::steady_clock::now();
+        if (traversals == 0) throw std::invalid_argument("reachability index needs at least one traversal");
+        if (snapshot.size() >= std::numeric_limits<std::uint32_t>::max()) throw std::invalid_argument("reachability index: too many vertices");
+
+        this->names = snapshot.names;
+        this->ids = snapshot.ids;
+
+        auto scc = strongly_connected_components(snapshot);
+        this->components = scc.count;
+        this->component.assign(scc.component.begin(), scc.component.end());
+
+        // condensation in CSR form, one arc per pair of components
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> arcs;
+        for (std::size_t v = 0; v < snapshot.size(); v++) {
+            for (auto arc : snapshot.neighbours(v)) {
+                auto from = this->component[v], to = this->component[arc.to];
+                if (from != to) arcs.emplace_back(from, to);
+            }
+        }
+        std::sort(arcs.begin(), arcs.end());
+        arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+        this->offsets.assign(this->components + 1, 0);
+        this->targets.reserve(arcs.size());
+        for (auto [from, to] : arcs) {
+            this->offsets[from + 1]++;
+            this->targets.push_back(to);
+        }
+        for (std::size_t c = 0; c < this->components; c++) this->offsets[c + 1] += this->offsets[c];
+
+        label(traversals);
+        this->build_seconds = seconds_since(start);
+    }
+
+    ReachabilityIndex::ReachabilityIndex(Graph& graph, std::size_t traversals) : ReachabilityIndex(Snapshot(graph), traversals) { }
+
+    void ReachabilityIndex::label(std::size_t traversals) {
+        auto n = this->components;
+        this->traversals = traversals;
+        this->rank.assign(traversals * n, 0);
+        this->low.assign(traversals * n, 0);
+        this->tree_low.assign(n, 0);
+
+        // The first traversal visits roots and children in index order, the others in
+        // a seeded random order so that the labels differ and prune different pairs.
+        std::vector<std::uint32_t> roots(n), children(this->targets.begin(), this->targets.end());
+        for (std::size_t c = 0; c < n; c++) roots[c] = c;
+
+        std::vector<char> visited;
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> stack;
+        std::mt19937_64 random(0x7467726964ull);
+
+        for (std::size_t d = 0; d < traversals; d++) {
+            auto* rank = this->rank.data() + d * n;
+            auto* low = this->low.data() + d * n;
+
+            if (d > 0) {
+                std::shuffle(roots.begin(), roots.end(), random);
+                for (std::size_t c = 0; c < n; c++) std::shuffle(children.begin() + this->offsets[c], children.begin() + this->offsets[c + 1], random);
+            }
+
+            visited.assign(n, false);
+            std::uint32_t next = 0;
+            auto enter = [&](std::uint32_t c) {
+                visited[c] = true;
+                // whatever finishes before c does is in c's subtree of the DFS forest
+                if (d == 0) this->tree_low[c] = next;
+                stack.emplace_back(c, this->offsets[c]);
+            };
+
+            for (auto root : roots) {
+                if (visited[root]) continue;
+                enter(root);
+
+                while (!stack.empty()) {
+                    auto c = stack.back().first;
+                    auto& edge = stack.back().second;
+                    if (edge < this->offsets[c + 1]) {
+                        auto child = children[edge++];
+                        if (!visited[child]) enter(child);
+                        continue;
+                    }
+                    stack.pop_back();
+
+                    // the condensation is acyclic, so every child has finished by now
+                    rank[c] = next++;
+                    low[c] = rank[c];
+                    for (auto e = this->offsets[c]; e < this->offsets[c + 1]; e++) low[c] = std::min(low[c], low[children[e]]);
+                }
+            }
+        }
+    }
+
+    bool ReachabilityIndex::try_labels(std::size_t from, std::size_t to, bool& reachable) const {
+        auto a = this->component[from], b = this->component[to];
+
+        if (a == b) {
+            reachable = true;
+            return true;
+        }
+        // Tarjan numbers components in reverse topological order
+        if (a < b || excluded(a, b)) {
+            reachable = false;
+            return true;
+        }
+        if (this->tree_low[a] <= this->rank[b] && this->rank[b] <= this->rank[a]) {
+            reachable = true;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReachabilityIndex::reachable(std::size_t from, std::size_t to) const {
+        bool res;
+        if (try_labels(from, to, res)) return res;
+        return search(this->component[from], this->component[to]);
+    }
+
+    bool ReachabilityIndex::reachable(const std::string& from, const std::string& to) const {
+        auto a = this->ids.find(from), b = this->ids.find(to);
+        if (a == this->ids.end() || b == this->ids.end()) return false;
+        return reachable(a->second, b->second);
+    }
+
+    bool ReachabilityIndex::search(std::uint32_t from, std::uint32_t to) const {
+        // Per-thread visited marks, stamped so that they need no clearing between
+        // queries; they are reset whenever the thread switches to another index.
+        thread_local const ReachabilityIndex* owner = nullptr;
+        thread_local std::vector<std::uint32_t> marks;
+        thread_local std::uint32_t stamp = 0;
+        thread_local std::vector<std::uint32_t> stack;
+
+        if (owner != this || marks.size() != this->components || ++stamp == 0) {
+            owner = this;
+            marks.assign(this->components, 0);
+            stamp = 1;
+        }
+
+        stack.clear();
+        stack.push_back(from);
+        marks[from] = stamp;
+
+        while (!stack.empty()) {
+            auto c = stack.back();
+            stack.pop_back();
+
+            for (auto e = this->offsets[c]; e < this->offsets[c + 1]; e++) {
+                auto next = this->targets[e];
+                if (next == to) return true;
+                if (marks[next] == stamp || next < to || excluded(next, to)) continue;
+                if (this->tree_low[next] <= this->rank[to] && this->rank[to] <= this->rank[next]) return true;
+
+                marks[next] = stamp;
+                stack.push_back(next);
+            }
+        }
+        return false;
+    }
+
+    std::size_t ReachabilityIndex::size() const {
+        return this->component.size();
+    }
+
+    std::size_t ReachabilityIndex::component_count() const {
+        return this->components;
+    }
+
+    std::size_t ReachabilityIndex::memory_bytes() const {
+        std::size_t res = sizeof(*this);
+        for (auto& name : this->names) res += sizeof(std::string) + name.capacity();
+        // one node with key, value and next pointer per id, plus the bucket array
+        for (auto& [name, id] : this->ids) res += sizeof(std::string) + name.capacity() + sizeof(std::size_t) + sizeof(void*);
+        res += this->ids.bucket_count() * sizeof(void*);
+
+        res += this->component.capacity() * sizeof(std::uint32_t);
+        res += this->offsets.capacity() * sizeof(std::uint64_t);
+        res += this->targets.capacity() * sizeof(std::uint32_t);
+        res += (this->rank.capacity() + this->low.capacity() + this->tree_low.capacity()) * sizeof(std::uint32_t);
+        return res;
+    }
+
+    void ReachabilityIndex::save(std::ostream& out) const {
+        using detail::write;
+
+        out.write(magic, sizeof(magic));
+        write(out, format_version);
+        write<std::uint64_t>(out, this->names.size());
+        for (auto& name : this->names) write(out, name);
+
+        write<std::uint64_t>(out, this->components);
+        write<std::uint64_t>(out, this->traversals);
+        write(out, this->component);
+        write(out, this->offsets);
+        write(out, this->targets);
+        write(out, this->rank);
+        write(out, this->low);
+        write(out, this->tree_low);
+
+        if (!out) throw std::runtime_error("reachability index: write failed");
+    }
+
+    ReachabilityIndex ReachabilityIndex::load(std::istream& in) {
+        using detail::read;
+        using detail::read_vector;
+
+        auto start = std::chrono::steady_clock::now();
+        ReachabilityIndex res;
+
+        char header[sizeof(magic)];
+        if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic)) {
+            throw std::runtime_error("reachability index: not an index");
+        }
+        if (read<std::uint32_t>(in, what) != format_version) throw std::runtime_error("reachability index: unsupported version");
+
+        auto n = read<std::uint64_t>(in, what);
+        for (std::uint64_t v = 0; v < n; v++) {
+            res.names.push_back(detail::read_string(in, what));
+            res.ids.emplace(res.names[v], v);
+        }
+
+        res.components = read<std::uint64_t>(in, what);
+        res.traversals = read<std::uint64_t>(in, what);
+        if (res.traversals == 0 || res.components > n) throw std::runtime_error("reachability index: corrupt header");
+        if (res.components > 0 && res.traversals > std::numeric_limits<std::uint64_t>::max() / res.components) {
+            throw std::runtime_error("reachability index: corrupt header");
+        }
+
+        res.component = read_vector<std::uint32_t>(in, n, what);
+        res.offsets = read_vector<std::uint64_t>(in, res.components + 1, what);
+
+        // offsets.back() sizes the targets, so it is checked before they are read
+        for (std::size_t c = 0; c < res.components; c++) {
+            if (res.offsets[0] != 0 || res.offsets[c] > res.offsets[c + 1]) throw std::runtime_error("reachability index: corrupt offsets");
+        }
+        res.targets = read_vector<std::uint32_t>(in, res.offsets.back(), what);
+        res.rank = read_vector<std::uint32_t>(in, res.traversals * res.components, what);
+        res.low = read_vector<std::uint32_t>(in, res.traversals * res.components, what);
+        res.tree_low = read_vector<std::uint32_t>(in, res.components, what);
+
+        // queries index with these without further checks
+        for (auto c : res.component) {
+            if (c >= res.components) throw std::runtime_error("reachability index: corrupt component");
+        }
+        for (auto c : res.targets) {
+            if (c >= res.components) throw std::runtime_error("reachability index: corrupt target");
+        }
+
+        res.build_seconds = seconds_since(start);
+        return res;
+    }
+}
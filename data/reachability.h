@@ -0,0 +1,90 @@
+#ifndef TINYGRAPH_REACHABILITY_H
+#define TINYGRAPH_REACHABILITY_H
+
+#include "snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tinygraph {
+    class Graph;
+
+    // Answers "is there a directed path from a to b" without walking the graph in most
+    // cases. Strongly connected components are collapsed into a DAG (so vertices of
+    // the same component reach each other trivially), and every DAG node gets
+    // GRAIL-style interval labels from a few randomized depth-first traversals: if
+    // b's interval is not inside a's in every traversal, b is unreachable; if b is a
+    // DFS-tree descendant of a in the first traversal, it is reachable. Only queries
+    // that neither test decides fall back to a depth-first search over the DAG,
+    // pruned by the same labels.
+    //
+    // The index is immutable once built and may be queried from many threads.
+    class ReachabilityIndex {
+    public:
+        explicit ReachabilityIndex(const Snapshot& snapshot, std::size_t traversals = 3);
+
+        explicit ReachabilityIndex(Graph& graph, std::size_t traversals = 3);
+
+        // Snapshot ids.
+        bool reachable(std::size_t from, std::size_t to) const;
+
+        // False if either vertex is unknown.
+        bool reachable(const std::string& from, const std::string& to) const;
+
+        // True if the labels alone decide the query, with the answer in `reachable`.
+        bool try_labels(std::size_t from, std::size_t to, bool& reachable) const;
+
+        std::size_t size() const;
+
+        std::size_t component_count() const;
+
+        std::size_t memory_bytes() const;
+
+        // Wall time spent building (or loading) the index.
+        double build_seconds = 0;
+
+        // Binary format in host byte order; load throws std::runtime_error on anything
+        // it cannot read back.
+        void save(std::ostream& out) const;
+
+        static ReachabilityIndex load(std::istream& in);
+
+    private:
+        ReachabilityIndex() = default;
+
+        void label(std::size_t traversals);
+
+        bool search(std::uint32_t from, std::uint32_t to) const;
+
+        bool excluded(std::uint32_t from, std::uint32_t to) const {
+            for (std::size_t d = 0; d < traversals; d++) {
+                auto base = d * components;
+                if (low[base + to] < low[base + from] || rank[base + to] > rank[base + from]) return true;
+            }
+            return false;
+        }
+
+        std::vector<std::string> names;
+        std::unordered_map<std::string, std::size_t> ids;
+
+        // component of every vertex; Tarjan numbering, so edges only go to smaller ids
+        std::vector<std::uint32_t> component;
+        std::size_t components = 0;
+
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint32_t> targets;
+
+        // per traversal d, entries d * components + c: post-order rank of c and the
+        // lowest rank among everything c reaches
+        std::size_t traversals = 0;
+        std::vector<std::uint32_t> rank;
+        std::vector<std::uint32_t> low;
+        // lowest rank in c's subtree of the first traversal's DFS forest
+        std::vector<std::uint32_t> tree_low;
+    };
+}
+
+#endif //TINYGRAPH_REACHABILITY_H
@@ -0,0 +1,224 @@
+#include "shard.h"
+#include "binary.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace tinygraph {
+    namespace {
+        constexpr char magic[4] = {'T', 'G', 'S', 'H'};
+        constexpr std::uint32_t format_version = 1;
+        constexpr char what[] = "shard";
+    }
+
+    std::vector<std::uint32_t> partition(const Snapshot& snapshot, std::size_t parts, PartitionStrategy strategy) {
+        auto n = snapshot.size();
+        parts = std::max<std::size_t>(parts, 1);
+        std::vector<std::uint32_t> owner(n);
+
+        if (strategy == PartitionStrategy::hash) {
+            for (std::size_t v = 0; v < n; v++) owner[v] = std::hash<std::string>()(snapshot.names[v]) % parts;
+            return owner;
+        }
+
+        std::vector<std::size_t> reverse_offsets, sources;
+        snapshot.transpose(reverse_offsets, sources);
+
+        const std::uint32_t unassigned = parts;
+        std::fill(owner.begin(), owner.end(), unassigned);
+
+        auto capacity = double((n + parts - 1) / parts);
+        std::vector<std::size_t> load(parts, 0);
+        std::vector<std::size_t> neighbours(parts, 0);
+
+        for (std::size_t v = 0; v < n; v++) {
+            std::fill(neighbours.begin(), neighbours.end(), 0);
+            for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                auto part = owner[snapshot.targets[e]];
+                if (part != unassigned) neighbours[part]++;
+            }
+            for (auto e = reverse_offsets[v]; e < reverse_offsets[v + 1]; e++) {
+                auto part = owner[sources[e]];
+                if (part != unassigned) neighbours[part]++;
+            }
+
+            std::size_t best = 0;
+            double best_score = -1;
+            for (std::size_t part = 0; part < parts; part++) {
+                if (load[part] >= capacity) continue;
+
+                auto score = neighbours[part] * (1 - load[part] / capacity);
+                if (score > best_score || (score == best_score && load[part] < load[best])) {
+                    best = part;
+                    best_score = score;
+                }
+            }
+
+            owner[v] = best;
+            load[best]++;
+        }
+
+        return owner;
+    }
+
+    std::size_t edge_cut(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner) {
+        std::size_t res = 0;
+        for (std::size_t v = 0; v < snapshot.size(); v++) {
+            for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                if (owner[v] != owner[snapshot.targets[e]]) res++;
+            }
+        }
+        return res;
+    }
+
+    Shard::Arcs Shard::neighbours(std::size_t vertex) const {
+        if (vertex >= owned) return {ArcIterator(this, 0), ArcIterator(this, 0)};
+        return {ArcIterator(this, offsets[vertex]), ArcIterator(this, offsets[vertex + 1])};
+    }
+
+    std::size_t Shard::size() const {
+        return global.size();
+    }
+
+    bool Shard::is_ghost(std::size_t vertex) const {
+        return vertex >= owned;
+    }
+
+    Shard make_shard(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t rank) {
+        Shard shard;
+        shard.rank = rank;
+        shard.global_size = snapshot.size();
+        shard.offsets.push_back(0);
+
+        auto add = [&snapshot, &owner, &shard](std::size_t v) {
+            shard.local.emplace(v, shard.global.size());
+            shard.names.push_back(snapshot.names[v]);
+            shard.global.push_back(v);
+            shard.owner.push_back(owner[v]);
+        };
+
+        for (std::size_t v = 0; v < snapshot.size(); v++) {
+            if (owner[v] == rank) add(v);
+        }
+        shard.owned = shard.global.size();
+
+        for (std::size_t l = 0; l < shard.owned; l++) {
+            auto v = shard.global[l];
+            for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                auto target = snapshot.targets[e];
+                if (!shard.local.count(target)) add(target);
+
+                shard.targets.push_back(shard.local[target]);
+                if (!snapshot.weights.empty()) shard.weights.push_back(snapshot.weights[e]);
+            }
+            shard.offsets.push_back(shard.targets.size());
+        }
+
+        return shard;
+    }
+
+    std::vector<Shard> make_shards(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t parts) {
+        std::vector<Shard> shards;
+        shards.reserve(std::max<std::size_t>(parts, 1));
+        for (std::size_t r = 0; r < std::max<std::size_t>(parts, 1); r++) shards.push_back(make_shard(snapshot, owner, r));
+        return shards;
+    }
+
+    std::vector<std::string> save_shards(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t parts, const std::string& prefix) {
+        std::vector<std::string> paths;
+        for (std::size_t r = 0; r < std::max<std::size_t>(parts, 1); r++) {
+            paths.push_back(prefix + std::to_string(r));
+
+            std::ofstream out(paths.back(), std::ios::binary);
+            if (!out) throw std::runtime_error("shard: cannot write " + paths.back());
+            make_shard(snapshot, owner, r).save(out);
+        }
+        return paths;
+    }
+
+    Shard load_shard(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("shard: cannot read " + path);
+        return Shard::load(in);
+    }
+
+    void Shard::save(std::ostream& out) const {
+        using detail::write;
+
+        out.write(magic, sizeof(magic));
+        write(out, format_version);
+        write<std::uint64_t>(out, this->rank);
+        write<std::uint64_t>(out, this->owned);
+        write<std::uint64_t>(out, this->global_size);
+
+        write<std::uint64_t>(out, this->names.size());
+        for (auto& name : this->names) write(out, name);
+
+        std::vector<std::uint64_t> global(this->global.begin(), this->global.end());
+        std::vector<std::uint64_t> offsets(this->offsets.begin(), this->offsets.end());
+        std::vector<std::uint64_t> targets(this->targets.begin(), this->targets.end());
+        write(out, global);
+        write(out, this->owner);
+        write(out, offsets);
+        write(out, targets);
+        write(out, this->weights);
+
+        if (!out) throw std::runtime_error("shard: write failed");
+    }
+
+    Shard Shard::load(std::istream& in) {
+        using detail::read;
+        using detail::read_vector;
+
+        Shard res;
+
+        char header[sizeof(magic)];
+        if (!in.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic)) {
+            throw std::runtime_error("shard: not a shard");
+        }
+        if (read<std::uint32_t>(in, what) != format_version) throw std::runtime_error("shard: unsupported version");
+
+        res.rank = read<std::uint64_t>(in, what);
+        res.owned = read<std::uint64_t>(in, what);
+        res.global_size = read<std::uint64_t>(in, what);
+
+        auto n = read<std::uint64_t>(in, what);
+        if (res.owned > n || n > res.global_size) throw std::runtime_error("shard: corrupt header");
+        // every name takes at least its length field, so a count past the input fails here
+        for (std::uint64_t l = 0; l < n; l++) res.names.push_back(detail::read_string(in, what));
+
+        auto global = read_vector<std::uint64_t>(in, n, what);
+        res.owner = read_vector<std::uint32_t>(in, n, what);
+        auto offsets = read_vector<std::uint64_t>(in, res.owned + 1, what);
+
+        // offsets.back() sizes the next two arrays, so it is checked before they are read
+        if (offsets[0] != 0) throw std::runtime_error("shard: corrupt offsets");
+        for (std::size_t l = 0; l < res.owned; l++) {
+            if (offsets[l] > offsets[l + 1]) throw std::runtime_error("shard: corrupt offsets");
+        }
+        auto targets = read_vector<std::uint64_t>(in, offsets.back(), what);
+
+        auto weights = read<std::uint64_t>(in, what);
+        if (weights != 0 && weights != targets.size()) throw std::runtime_error("shard: inconsistent array size");
+        res.weights = detail::read_items<double>(in, weights, what);
+
+        // the algorithms index with these without further checks
+        res.global.assign(global.begin(), global.end());
+        res.offsets.assign(offsets.begin(), offsets.end());
+        res.targets.assign(targets.begin(), targets.end());
+        for (std::size_t l = 0; l < n; l++) {
+            if (res.global[l] >= res.global_size || !res.local.emplace(res.global[l], l).second) throw std::runtime_error("shard: corrupt vertex");
+            // this rank owns exactly its first `owned` vertices; the rank count is the
+            // transport's, so the distributed algorithms check the upper bound
+            if ((res.owner[l] == res.rank) != (l < res.owned)) throw std::runtime_error("shard: corrupt owner");
+        }
+        for (auto target : res.targets) {
+            if (target >= n) throw std::runtime_error("shard: corrupt target");
+        }
+
+        return res;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef TINYGRAPH_SHARD_H
+#define TINYGRAPH_SHARD_H
+
+#include "snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tinygraph {
+    // hash spreads vertices by name and ignores the edges; greedy is linear
+    // deterministic greedy streaming, which puts every vertex with the part holding
+    // most of its neighbours, weighted by how much room that part has left, so that
+    // fewer edges are cut.
+    enum class PartitionStrategy { hash, greedy };
+
+    // owner[v] in [0, parts) for every snapshot vertex. greedy never makes a part
+    // larger than ceil(size / parts).
+    std::vector<std::uint32_t> partition(const Snapshot& snapshot, std::size_t parts, PartitionStrategy strategy);
+
+    // Edges whose endpoints have different owners.
+    std::size_t edge_cut(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner);
+
+    // The part of a partitioned snapshot that one rank works on: the vertices it owns,
+    // their outgoing edges, and a ghost copy of every vertex those edges lead to that
+    // another rank owns. Local ids 0..owned-1 are the owned vertices in snapshot order,
+    // owned..size()-1 the ghosts. Only owned vertices have arcs, so a shard can be
+    // passed to the traversal templates like any other adjacency.
+    class Shard {
+    public:
+        class ArcIterator {
+        public:
+            ArcIterator(const Shard* shard, std::size_t edge) : shard(shard), edge(edge) { }
+
+            Arc operator*() const {
+                return {shard->targets[edge], shard->weights.empty() ? 1.0 : shard->weights[edge], edge};
+            }
+
+            ArcIterator& operator++() {
+                edge++;
+                return *this;
+            }
+
+            bool operator!=(const ArcIterator& other) const { return edge != other.edge; }
+            bool operator==(const ArcIterator& other) const { return edge == other.edge; }
+
+        private:
+            const Shard* shard;
+            std::size_t edge;
+        };
+
+        struct Arcs {
+            ArcIterator first;
+            ArcIterator last;
+
+            ArcIterator begin() const { return first; }
+            ArcIterator end() const { return last; }
+        };
+
+        Arcs neighbours(std::size_t vertex) const;
+
+        std::size_t size() const;
+
+        bool is_ghost(std::size_t vertex) const;
+
+        std::size_t rank = 0;
+        std::size_t owned = 0;
+        // vertices in the whole snapshot
+        std::size_t global_size = 0;
+
+        std::vector<std::string> names;
+        // snapshot id and owning rank of every local vertex
+        std::vector<std::size_t> global;
+        std::vector<std::uint32_t> owner;
+        std::unordered_map<std::size_t, std::size_t> local;
+
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+        std::vector<double> weights;
+
+        // Binary format in host byte order; load throws std::runtime_error on anything
+        // it cannot read back.
+        void save(std::ostream& out) const;
+
+        static Shard load(std::istream& in);
+    };
+
+    // The shard of one rank.
+    Shard make_shard(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t rank);
+
+    // One shard per part, shards[r].rank == r.
+    std::vector<Shard> make_shards(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t parts);
+
+    // Writes the shard of every part to prefix + rank, building one at a time, and
+    // returns the paths. Ranks that load only their own file hold their shard and its
+    // ghosts rather than the whole graph. Throws std::runtime_error if a file cannot
+    // be written.
+    std::vector<std::string> save_shards(const Snapshot& snapshot, const std::vector<std::uint32_t>& owner, std::size_t parts, const std::string& prefix);
+
+    Shard load_shard(const std::string& path);
+}
+
+#endif //TINYGRAPH_SHARD_H
@@ -0,0 +1,228 @@
+#include "snapshot.h"
+#include "graph.h"
+#include <functions/parallel.h>
+#include <functions/util.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace tinygraph {
+    namespace {
+        std::vector<std::size_t> total_degrees(const Snapshot& snapshot, const std::vector<std::size_t>& reverse_offsets) {
+            std::vector<std::size_t> degree(snapshot.size());
+            for (std::size_t v = 0; v < degree.size(); v++) {
+                degree[v] = snapshot.degree(v) + reverse_offsets[v + 1] - reverse_offsets[v];
+            }
+            return degree;
+        }
+
+        // Breadth-first numbering over edges in both directions, one component at a time.
+        // Cuthill-McKee starts every component at a vertex of minimum degree, visits
+        // neighbours by increasing degree and is reversed at the end; plain bfs starts
+        // at the highest-degree vertex and keeps adjacency order.
+        std::vector<std::size_t> breadth_first_order(const Snapshot& snapshot, bool cuthill_mckee) {
+            std::vector<std::size_t> reverse_offsets, sources;
+            snapshot.transpose(reverse_offsets, sources);
+            auto degree = total_degrees(snapshot, reverse_offsets);
+
+            std::vector<std::size_t> roots(snapshot.size());
+            std::iota(roots.begin(), roots.end(), 0);
+            std::stable_sort(roots.begin(), roots.end(), [&](std::size_t a, std::size_t b) {
+                return cuthill_mckee ? degree[a] < degree[b] : degree[a] > degree[b];
+            });
+
+            std::vector<bool> visited(snapshot.size(), false);
+            std::vector<std::size_t> order;
+            order.reserve(snapshot.size());
+            std::vector<std::size_t> found;
+
+            for (auto root : roots) {
+                if (visited[root]) continue;
+
+                visited[root] = true;
+                order.push_back(root);
+
+                for (auto head = order.size() - 1; head < order.size(); head++) {
+                    auto v = order[head];
+
+                    found.clear();
+                    for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                        if (!visited[snapshot.targets[e]]) found.push_back(snapshot.targets[e]);
+                    }
+                    for (auto e = reverse_offsets[v]; e < reverse_offsets[v + 1]; e++) {
+                        if (!visited[sources[e]]) found.push_back(sources[e]);
+                    }
+
+                    if (cuthill_mckee) {
+                        std::stable_sort(found.begin(), found.end(), [&degree](std::size_t a, std::size_t b) {
+                            return degree[a] < degree[b];
+                        });
+                    }
+
+                    for (auto w : found) {
+                        if (visited[w]) continue;
+                        visited[w] = true;
+                        order.push_back(w);
+                    }
+                }
+            }
+
+            if (cuthill_mckee) std::reverse(order.begin(), order.end());
+            return order;
+        }
+    }
+
+    Snapshot::Snapshot(Graph& graph, const std::string& weight_property, Ordering ordering) {
+        names.reserve(graph.vertices.size());
+        vertices.reserve(graph.vertices.size());
+
+        for (const auto& [name, vertex] : graph.vertices) {
+            ids[name] = names.size();
+            names.push_back(name);
+            vertices.push_back(vertex);
+            type_ids.push_back(vertex->type_id);
+        }
+
+        offsets.reserve(names.size() + 1);
+        offsets.push_back(0);
+
+        for (const auto& vertex : vertices) {
+            for (const auto& edge : vertex->connections) {
+                if (!edge->live()) continue;
+
+                auto target = ids.find(edge->to->name);
+                if (target == ids.end()) continue;
+
+                targets.push_back(target->second);
+                edges.push_back(edge);
+
+                if (weight_property.empty()) continue;
+
+                double weight;
+                if (!edge->properties || edge->properties->count(weight_property) == 0 || !any_to_double(&edge->properties->at(weight_property), weight)) {
+                    throw std::invalid_argument("edge " + vertex->name + " -> " + edge->to->name + " has no numeric " + weight_property);
+                }
+                weights.push_back(weight);
+            }
+            offsets.push_back(targets.size());
+        }
+
+        // Graph::vertices already iterates by name; reorder() would only sort the arcs
+        if (ordering != Ordering::name) reorder(ordering);
+    }
+
+    Snapshot::Arcs Snapshot::neighbours(std::size_t vertex) const {
+        return {ArcIterator(this, offsets[vertex]), ArcIterator(this, offsets[vertex + 1])};
+    }
+
+    std::size_t Snapshot::size() const {
+        return names.size();
+    }
+
+    std::size_t Snapshot::degree(std::size_t vertex) const {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+
+    std::size_t Snapshot::id(const std::string& name) const {
+        return ids.at(name);
+    }
+
+    void Snapshot::reorder(Ordering ordering) {
+        auto n = size();
+
+        // order[new id] = old id
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+
+        switch (ordering) {
+            case Ordering::name:
+                std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return names[a] < names[b]; });
+                break;
+            case Ordering::degree: {
+                std::vector<std::size_t> reverse_offsets, sources;
+                transpose(reverse_offsets, sources);
+                auto degree = total_degrees(*this, reverse_offsets);
+                std::stable_sort(order.begin(), order.end(), [&degree](std::size_t a, std::size_t b) { return degree[a] > degree[b]; });
+                break;
+            }
+            case Ordering::rcm:
+                order = breadth_first_order(*this, true);
+                break;
+            case Ordering::bfs:
+                order = breadth_first_order(*this, false);
+                break;
+        }
+
+        std::vector<std::size_t> renamed(n);
+        for (std::size_t v = 0; v < n; v++) renamed[order[v]] = v;
+
+        std::vector<std::string> new_names(n);
+        std::vector<std::shared_ptr<Vertex>> new_vertices(n);
+        std::vector<std::uint32_t> new_type_ids(n);
+        std::vector<std::size_t> new_offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; v++) {
+            new_names[v] = std::move(names[order[v]]);
+            new_vertices[v] = std::move(vertices[order[v]]);
+            new_type_ids[v] = type_ids[order[v]];
+            new_offsets[v + 1] = new_offsets[v] + degree(order[v]);
+            ids[new_names[v]] = v;
+        }
+
+        std::vector<std::size_t> new_targets(targets.size());
+        std::vector<std::shared_ptr<Edge>> new_edges(edges.size());
+        std::vector<double> new_weights(weights.size());
+
+        parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+            std::vector<std::size_t> arcs;
+            for (auto v = lo; v < hi; v++) {
+                auto old = order[v];
+
+                arcs.resize(degree(old));
+                std::iota(arcs.begin(), arcs.end(), offsets[old]);
+                std::stable_sort(arcs.begin(), arcs.end(), [&](std::size_t a, std::size_t b) {
+                    return renamed[targets[a]] < renamed[targets[b]];
+                });
+
+                auto out = new_offsets[v];
+                for (auto e : arcs) {
+                    new_targets[out] = renamed[targets[e]];
+                    new_edges[out] = edges[e];
+                    if (!weights.empty()) new_weights[out] = weights[e];
+                    out++;
+                }
+            }
+        });
+
+        names = std::move(new_names);
+        vertices = std::move(new_vertices);
+        type_ids = std::move(new_type_ids);
+        offsets = std::move(new_offsets);
+        targets = std::move(new_targets);
+        edges = std::move(new_edges);
+        weights = std::move(new_weights);
+    }
+
+    void Snapshot::transpose(std::vector<std::size_t>& reverse_offsets, std::vector<std::size_t>& sources) const {
+        auto n = size();
+
+        reverse_offsets.assign(n + 1, 0);
+        for (auto w : targets) reverse_offsets[w + 1]++;
+        std::partial_sum(reverse_offsets.begin(), reverse_offsets.end(), reverse_offsets.begin());
+
+        sources.resize(targets.size());
+        auto fill = reverse_offsets;
+        for (std::size_t v = 0; v < n; v++) {
+            for (auto e = offsets[v]; e < offsets[v + 1]; e++) {
+                sources[fill[targets[e]]++] = v;
+            }
+        }
+    }
+
+    TypeFilter::TypeFilter(const Snapshot& snapshot, const std::vector<std::shared_ptr<Type>>& types) : type_ids(&snapshot.type_ids) {
+        for (const auto& type : types) {
+            if (!type || type->id == Type::unregistered) continue;
+            if (type->id >= allowed.size()) allowed.resize(type->id + 1, false);
+            allowed[type->id] = true;
+        }
+    }
+}
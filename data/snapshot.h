@@ -0,0 +1,114 @@
+#ifndef TINYGRAPH_SNAPSHOT_H
+#define TINYGRAPH_SNAPSHOT_H
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace tinygraph {
+    class Graph;
+
+    // Vertex numbering of a snapshot. `name` keeps the lexicographic order of
+    // Graph::vertices; the others renumber vertices so that neighbours end up close to
+    // each other in memory: `degree` puts high-degree vertices first, `rcm` is Reverse
+    // Cuthill-McKee and `bfs` numbers vertices in breadth-first visiting order. rcm and
+    // bfs treat edges as undirected.
+    enum class Ordering { name, degree, rcm, bfs };
+
+    struct Arc {
+        std::size_t to;
+        double weight;
+        std::size_t edge;
+    };
+
+    // Read-only copy of a Graph's adjacency with vertices numbered 0..size()-1 and the
+    // outgoing edges of vertex v stored in targets[offsets[v]] .. targets[offsets[v + 1] - 1].
+    // The algorithms that need integer ids build one of these instead of walking the
+    // name-keyed vertex map.
+    //
+    // With a weight property, weights[e] holds that property of edge e as a double; the
+    // constructor throws std::invalid_argument if an edge lacks it or it is not an
+    // int, float or double.
+    class Snapshot {
+    public:
+        explicit Snapshot(Graph& graph, const std::string& weight_property = "", Ordering ordering = Ordering::name);
+
+        // No vertices; for code that fills in the arrays itself.
+        Snapshot() = default;
+
+        class ArcIterator {
+        public:
+            ArcIterator(const Snapshot* snapshot, std::size_t edge) : snapshot(snapshot), edge(edge) { }
+
+            Arc operator*() const {
+                return {snapshot->targets[edge], snapshot->weights.empty() ? 1.0 : snapshot->weights[edge], edge};
+            }
+
+            ArcIterator& operator++() {
+                edge++;
+                return *this;
+            }
+
+            bool operator!=(const ArcIterator& other) const { return edge != other.edge; }
+            bool operator==(const ArcIterator& other) const { return edge == other.edge; }
+
+        private:
+            const Snapshot* snapshot;
+            std::size_t edge;
+        };
+
+        struct Arcs {
+            ArcIterator first;
+            ArcIterator last;
+
+            ArcIterator begin() const { return first; }
+            ArcIterator end() const { return last; }
+        };
+
+        // Outgoing arcs of a vertex; the weight is 1 when the snapshot has no weights.
+        Arcs neighbours(std::size_t vertex) const;
+
+        std::size_t size() const;
+
+        std::size_t degree(std::size_t vertex) const;
+
+        std::size_t id(const std::string& name) const;
+
+        // Renumbers the vertices; names, ids and edge order follow, and every vertex's
+        // arcs end up sorted by target.
+        void reorder(Ordering ordering);
+
+        // Incoming adjacency: the sources of the edges into v are
+        // sources[reverse_offsets[v]] .. sources[reverse_offsets[v + 1] - 1].
+        void transpose(std::vector<std::size_t>& reverse_offsets, std::vector<std::size_t>& sources) const;
+
+        std::vector<std::string> names;
+        std::vector<std::shared_ptr<Vertex>> vertices;
+        std::vector<std::uint32_t> type_ids;
+        std::unordered_map<std::string, std::size_t> ids;
+
+        std::vector<std::size_t> offsets;
+        std::vector<std::size_t> targets;
+        std::vector<std::shared_ptr<Edge>> edges;
+        std::vector<double> weights;
+    };
+
+    // Vertex filter for the traversal templates that accepts the snapshot vertices of
+    // the given types, reading only the snapshot's type_ids array.
+    class TypeFilter {
+    public:
+        TypeFilter(const Snapshot& snapshot, const std::vector<std::shared_ptr<Type>>& types);
+
+        bool operator()(std::size_t vertex) const {
+            auto type = (*type_ids)[vertex];
+            return type < allowed.size() && allowed[type];
+        }
+
+    private:
+        const std::vector<std::uint32_t>* type_ids;
+        std::vector<bool> allowed;
+    };
+}
+
+#endif //TINYGRAPH_SNAPSHOT_H
@@ -0,0 +1,57 @@
+#include "subgraph.h"
+
+namespace tinygraph {
+    Bitmap::Bitmap(std::size_t size, bool value) : words((size + 63) / 64, value ? ~std::uint64_t(0) : 0), bits(size) {
+        if (value && size % 64 != 0) words.back() = (std::uint64_t(1) << (size % 64)) - 1;
+    }
+
+    std::size_t Bitmap::count() const {
+        std::size_t res = 0;
+        for (auto word : words) res += __builtin_popcountll(word);
+        return res;
+    }
+
+    SubgraphView::SubgraphView(const Snapshot& snapshot, bool everything)
+            : snapshot(&snapshot), vertex_bits(snapshot.size(), everything), edge_bits(snapshot.targets.size(), everything) { }
+
+    SubgraphView::SubgraphView(const Snapshot& snapshot) : SubgraphView(snapshot, true) { }
+
+    SubgraphView::SubgraphView(const Snapshot& snapshot, const std::vector<std::size_t>& vertex_ids)
+            : snapshot(&snapshot), vertex_bits(snapshot.size(), false), edge_bits(snapshot.targets.size(), true) {
+        for (auto v : vertex_ids) vertex_bits.set(v, true);
+    }
+
+    SubgraphView::Arcs SubgraphView::neighbours(std::size_t vertex) const {
+        auto first = snapshot->offsets[vertex];
+        auto last = contains(vertex) ? snapshot->offsets[vertex + 1] : first;
+        return {ArcIterator(this, first, last), ArcIterator(this, last, last)};
+    }
+
+    std::size_t SubgraphView::size() const {
+        return snapshot->size();
+    }
+
+    bool SubgraphView::contains(std::size_t vertex) const {
+        return vertex_bits.test(vertex);
+    }
+
+    bool SubgraphView::contains_edge(std::size_t edge) const {
+        return edge_bits.test(edge);
+    }
+
+    void SubgraphView::keep_vertex(std::size_t vertex, bool keep) {
+        vertex_bits.set(vertex, keep);
+    }
+
+    void SubgraphView::keep_edge(std::size_t edge, bool keep) {
+        edge_bits.set(edge, keep);
+    }
+
+    std::size_t SubgraphView::vertex_count() const {
+        return vertex_bits.count();
+    }
+
+    const Snapshot& SubgraphView::parent() const {
+        return *snapshot;
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef TINYGRAPH_SUBGRAPH_H
+#define TINYGRAPH_SUBGRAPH_H
+
+#include "snapshot.h"
+#include <functions/parallel.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tinygraph {
+    class Bitmap {
+    public:
+        Bitmap() = default;
+        Bitmap(std::size_t size, bool value);
+
+        bool test(std::size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+        void set(std::size_t i, bool value) {
+            if (value) words[i >> 6] |= std::uint64_t(1) << (i & 63);
+            else words[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+        }
+
+        std::size_t size() const { return bits; }
+
+        std::size_t count() const;
+
+    private:
+        std::vector<std::uint64_t> words;
+        std::size_t bits = 0;
+    };
+
+    // A subset of a snapshot's vertices and edges, kept as two bitmaps over the
+    // snapshot's vertex and edge ids. Vertex ids are the snapshot's, so no data is
+    // copied; neighbours(v) only yields edges that are in the view and lead to a vertex
+    // in the view. The view can be passed to anything that takes an adjacency (bfs,
+    // dijkstra, bellman_ford, strongly_connected_components). The snapshot must
+    // outlive the view.
+    class SubgraphView {
+    public:
+        // Everything in the snapshot.
+        explicit SubgraphView(const Snapshot& snapshot);
+
+        // Exactly the given vertices, with every edge between them.
+        SubgraphView(const Snapshot& snapshot, const std::vector<std::size_t>& vertex_ids);
+
+        // The vertices and edges accepted by the predicates, which are called with a
+        // const Vertex& and a const Edge& respectively (in parallel).
+        template<typename VertexPredicate, typename EdgePredicate>
+        static SubgraphView where(const Snapshot& snapshot, VertexPredicate keep_vertex, EdgePredicate keep_edge) {
+            SubgraphView res(snapshot, false);
+
+            parallel_for(0, snapshot.size(), [&](std::size_t lo, std::size_t hi) {
+                for (auto v = lo; v < hi; v++) res.vertex_bits.set(v, keep_vertex(static_cast<const Vertex&>(*snapshot.vertices[v])));
+            }, 64 * 256);
+
+            parallel_for(0, snapshot.targets.size(), [&](std::size_t lo, std::size_t hi) {
+                for (auto e = lo; e < hi; e++) res.edge_bits.set(e, keep_edge(static_cast<const Edge&>(*snapshot.edges[e])));
+            }, 64 * 256);
+
+            return res;
+        }
+
+        class ArcIterator {
+        public:
+            ArcIterator(const SubgraphView* view, std::size_t edge, std::size_t last) : view(view), edge(edge), last(last) { skip(); }
+
+            Arc operator*() const { return *Snapshot::ArcIterator(view->snapshot, edge); }
+
+            ArcIterator& operator++() {
+                edge++;
+                skip();
+                return *this;
+            }
+
+            bool operator!=(const ArcIterator& other) const { return edge != other.edge; }
+            bool operator==(const ArcIterator& other) const { return edge == other.edge; }
+
+        private:
+            void skip() {
+                while (edge < last && !(view->edge_bits.test(edge) && view->vertex_bits.test(view->snapshot->targets[edge]))) edge++;
+            }
+
+            const SubgraphView* view;
+            std::size_t edge;
+            std::size_t last;
+        };
+
+        struct Arcs {
+            ArcIterator first;
+            ArcIterator last;
+
+            ArcIterator begin() const { return first; }
+            ArcIterator end() const { return last; }
+        };
+
+        // Empty for vertices outside the view.
+        Arcs neighbours(std::size_t vertex) const;
+
+        // Number of vertex ids, i.e. the snapshot's size; see vertex_count() for the
+        // number of vertices in the view.
+        std::size_t size() const;
+
+        bool contains(std::size_t vertex) const;
+
+        bool contains_edge(std::size_t edge) const;
+
+        void keep_vertex(std::size_t vertex, bool keep);
+
+        void keep_edge(std::size_t edge, bool keep);
+
+        std::size_t vertex_count() const;
+
+        const Snapshot& parent() const;
+
+    private:
+        SubgraphView(const Snapshot& snapshot, bool everything);
+
+        const Snapshot* snapshot;
+        Bitmap vertex_bits;
+        Bitmap edge_bits;
+    };
+}
+
+#endif //TINYGRAPH_SUBGRAPH_H
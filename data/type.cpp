@@ -7,7 +7,7 @@
 #include <utility>
 
 namespace tinygraph {
-    Type::Type(std::string name) {
+    Type::Type(std::string name, std::uint32_t id) : id(id) {
         this->name = std::move(name);
     }
 }
\ No newline at end of file
@@ -5,13 +5,19 @@
 #ifndef TINYGRAPH_TYPE_H
 #define TINYGRAPH_TYPE_H
 
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace tinygraph {
     class Type {
     public:
+        // id of types that were created directly instead of through the type store
+        static constexpr std::uint32_t unregistered = std::numeric_limits<std::uint32_t>::max();
+
         std::string name;
-        explicit Type(std::string name);
+        std::uint32_t id;
+        explicit Type(std::string name, std::uint32_t id = unregistered);
     };
 }
 
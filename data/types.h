@@ -9,23 +9,135 @@
 #include <memory>
 #include <map>
 #include <any>
+#include <unordered_map>
 #include <vector>
 #include "type.h"
 
 namespace tinygraph {
     class Edge;
+    class Vertex;
 
-    class Vertex {
+    // Notified about every write to a vertex's properties; before/after are null when
+    // the key did not exist before or was erased.
+    class PropertyObserver {
+    public:
+        virtual ~PropertyObserver() = default;
+        virtual void property_changed(Vertex& vertex, const std::string& key, const std::any* before, const std::any* after) = 0;
+    };
+
+    // Vertex properties. Reading works like the underlying std::map; every write goes
+    // through set(), insert(), erase() or operator[] so that the vertex's observers see
+    // it. As with std::map, reading operator[] of a missing key inserts an empty value.
+    class PropertyMap {
+    public:
+        using map_type = std::map<std::string, std::any>;
+
+        class Reference {
+        public:
+            Reference(PropertyMap* owner, std::string key) : owner(owner), key(std::move(key)) { }
+            Reference(const Reference&) = delete;
+
+            Reference& operator=(std::any value) {
+                owner->set(key, std::move(value));
+                return *this;
+            }
+
+            operator const std::any&() const { return get(); }
+
+            const std::any& get() const;
+
+            bool has_value() const { return get().has_value(); }
+
+            const std::type_info& type() const { return get().type(); }
+
+        private:
+            PropertyMap* owner;
+            std::string key;
+        };
+
+        explicit PropertyMap(Vertex* vertex) : vertex(vertex) { }
+        // copies the values for another vertex
+        PropertyMap(Vertex* vertex, const PropertyMap& other) : vertex(vertex), values(other.values) { }
+        PropertyMap(const PropertyMap&) = delete;
+        PropertyMap& operator=(const PropertyMap&) = delete;
+
+        Reference operator[](const std::string& key) { return {this, key}; }
+
+        void set(const std::string& key, std::any value);
+
+        // Adds the value unless the key exists, like std::map::insert.
+        std::pair<map_type::const_iterator, bool> insert(map_type::value_type value);
+
+        // Makes the values equal to other's, key by key.
+        void assign(const PropertyMap& other);
+
+        bool erase(const std::string& key);
+
+        const std::any& at(const std::string& key) const { return values.at(key); }
+
+        map_type::const_iterator find(const std::string& key) const { return values.find(key); }
+        map_type::size_type count(const std::string& key) const { return values.count(key); }
+        map_type::const_iterator begin() const { return values.begin(); }
+        map_type::const_iterator end() const { return values.end(); }
+        map_type::size_type size() const { return values.size(); }
+        bool empty() const { return values.empty(); }
+
+    private:
+        void notify(const std::string& key, const std::any* before, const std::any* after);
+
+        Vertex* vertex;
+        map_type values;
+    };
+
+    class Vertex : public std::enable_shared_from_this<Vertex> {
     public:
         Vertex(std::string, std::shared_ptr<Type>);
+        // A copy has the same name, type, edges and properties but no observers.
+        Vertex(const Vertex& other);
+        Vertex& operator=(const Vertex& other);
         ~Vertex();
 
         void add_prop(const char* key, std::any value);
 
         std::string name;
         std::shared_ptr<Type> type;
+        // type->id, kept next to the vertex so type filters need not follow `type`
+        std::uint32_t type_id;
         std::vector<std::shared_ptr<Edge>> connections;
-        std::map<std::string, std::any> properties;
+        PropertyMap properties;
+
+        // Every edge in `connections` by target, so that the edges between two vertices
+        // are found without walking the list. Only built once edges_into() is asked about
+        // a vertex with more than index_degree edges, so graphs that never remove an edge
+        // do not pay for it. From then on connect() keeps it current; compaction drops
+        // the entries of edges it erases.
+        std::unordered_multimap<const Vertex*, Edge*> edges_to;
+        bool edges_indexed = false;
+        static constexpr std::size_t index_degree = 32;
+
+        // The edges in `connections` into `to`, live or not.
+        std::vector<Edge*> edges_into(const Vertex* to);
+
+        // Stored edges from other vertices (and this one) into this vertex that are not
+        // tombstoned. Whoever links an edge counts it here; a copy starts at zero.
+        std::size_t in_edges = 0;
+
+        void connect(std::shared_ptr<Edge> edge);
+
+        // Erases the tombstoned edges and those into removed vertices from `connections`
+        // and `edges_to`, and returns how many there were.
+        std::size_t drop_dead_edges();
+
+        // One per graph holding the vertex (its property indexes), in no order.
+        std::vector<PropertyObserver*> observers;
+
+        void add_observer(PropertyObserver* observer);
+
+        void remove_observer(PropertyObserver* observer);
+
+        // Set once the vertex has been removed from its graph. Edges into it that are
+        // still stored elsewhere count as removed.
+        bool removed = false;
     };
 
     class Edge {
@@ -34,6 +146,15 @@ namespace tinygraph {
 
         std::shared_ptr<Vertex> to;
         std::shared_ptr<std::map<std::string, std::any>> properties;
+
+        // Tombstone: a removed edge stays in its vertex's connections until the graph
+        // is compacted, and every algorithm skips it.
+        bool removed = false;
+
+        // The other half of an undirected link, which shares `properties`.
+        std::weak_ptr<Edge> reverse;
+
+        bool live() const { return !removed && !to->removed; }
     };
 }
 
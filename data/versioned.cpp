@@ -0,0 +1,250 @@
+#include "versioned.h"
+#include <functions/util.h>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+namespace tinygraph {
+    VersionedGraph::Version::Base::Base(Graph& graph, const std::string& weight_property) : snapshot(graph, weight_property) {
+        properties.reserve(snapshot.size());
+        for (auto& vertex : snapshot.vertices) {
+            properties.push_back(std::make_shared<const PropertyMap::map_type>(vertex->properties.begin(), vertex->properties.end()));
+        }
+    }
+
+    VersionedGraph::Version::Base::Base(const Version& version, bool weighted) {
+        const auto& old = version.base->snapshot;
+        const auto& delta = *version.delta;
+        auto n = version.size();
+
+        snapshot.names = old.names;
+        snapshot.vertices = old.vertices;
+        snapshot.type_ids = old.type_ids;
+        snapshot.ids = old.ids;
+        properties = version.base->properties;
+
+        auto empty = std::make_shared<const PropertyMap::map_type>();
+        for (std::size_t i = 0; i < delta.added.size(); i++) {
+            const auto& added = delta.added[i];
+            snapshot.ids[added.name] = snapshot.names.size();
+            snapshot.names.push_back(added.name);
+            snapshot.vertices.push_back(added.vertex);
+            snapshot.type_ids.push_back(added.type_id);
+            properties.push_back(empty);
+        }
+
+        auto edge_count = old.targets.size() + delta.edges.size();
+        snapshot.offsets.reserve(n + 1);
+        snapshot.targets.reserve(edge_count);
+        snapshot.edges.reserve(edge_count);
+        if (weighted) snapshot.weights.reserve(edge_count);
+
+        snapshot.offsets.push_back(0);
+        for (std::size_t v = 0; v < n; v++) {
+            if (v < old.size()) {
+                for (auto e = old.offsets[v]; e < old.offsets[v + 1]; e++) {
+                    snapshot.targets.push_back(old.targets[e]);
+                    snapshot.edges.push_back(old.edges[e]);
+                    if (weighted) snapshot.weights.push_back(old.weights[e]);
+                }
+            }
+
+            if (auto extra = version.extra_arcs(v)) {
+                for (std::size_t i = 0; i < extra->size(); i++) {
+                    const auto& arc = (*extra)[i];
+                    snapshot.targets.push_back(arc.to);
+                    snapshot.edges.push_back(delta.edges[arc.edge - old.targets.size()]);
+                    if (weighted) snapshot.weights.push_back(arc.weight);
+                }
+            }
+            snapshot.offsets.push_back(snapshot.targets.size());
+
+            if (auto changed = delta.properties.find(v)) properties[v] = *changed;
+        }
+    }
+
+    Arc VersionedGraph::Version::ArcIterator::operator*() const {
+        auto degree = version->base_degree(vertex);
+        if (position < degree) return *Snapshot::ArcIterator(&version->base->snapshot, version->base->snapshot.offsets[vertex] + position);
+        return (*version->extra_arcs(vertex))[position - degree];
+    }
+
+    std::size_t VersionedGraph::Version::base_degree(std::size_t vertex) const {
+        return vertex < base->snapshot.size() ? base->snapshot.degree(vertex) : 0;
+    }
+
+    const SharedLog<Arc>* VersionedGraph::Version::extra_arcs(std::size_t vertex) const {
+        return delta->arcs.find(vertex);
+    }
+
+    VersionedGraph::Version::Arcs VersionedGraph::Version::neighbours(std::size_t vertex) const {
+        auto extra = extra_arcs(vertex);
+        auto degree = base_degree(vertex) + (extra ? extra->size() : 0);
+        return {ArcIterator(this, vertex, 0), ArcIterator(this, vertex, degree)};
+    }
+
+    std::size_t VersionedGraph::Version::size() const {
+        return base->snapshot.size() + delta->added.size();
+    }
+
+    std::size_t VersionedGraph::Version::id(const std::string& name) const {
+        auto it = base->snapshot.ids.find(name);
+        if (it != base->snapshot.ids.end()) return it->second;
+
+        auto added = delta->ids.find(name);
+        if (!added) throw std::out_of_range("no vertex " + name);
+        return *added;
+    }
+
+    const std::string& VersionedGraph::Version::name(std::size_t vertex) const {
+        auto count = base->snapshot.size();
+        return vertex < count ? base->snapshot.names[vertex] : delta->added[vertex - count].name;
+    }
+
+    std::uint32_t VersionedGraph::Version::type_id(std::size_t vertex) const {
+        auto count = base->snapshot.size();
+        return vertex < count ? base->snapshot.type_ids[vertex] : delta->added[vertex - count].type_id;
+    }
+
+    const std::any* VersionedGraph::Version::property(std::size_t vertex, const std::string& key) const {
+        const PropertyMap::map_type* properties = nullptr;
+        if (auto changed = delta->properties.find(vertex)) {
+            properties = changed->get();
+        } else if (vertex < base->properties.size()) {
+            properties = base->properties[vertex].get();
+        }
+        if (!properties) return nullptr;
+
+        auto it = properties->find(key);
+        return it == properties->end() ? nullptr : &it->second;
+    }
+
+    VersionedGraph::VersionedGraph(std::unique_ptr<Graph> graph, const std::string& weight_property, std::size_t merge_threshold)
+            : graph(std::move(graph)), weight_property(weight_property), merge_threshold(merge_threshold) {
+        publish(std::make_shared<Version::Base>(*this->graph, weight_property), std::make_shared<Version::Delta>());
+    }
+
+    std::shared_ptr<const VersionedGraph::Version> VersionedGraph::pin() const {
+        return std::atomic_load(&this->current);
+    }
+
+    void VersionedGraph::publish(std::shared_ptr<const Version::Base> base, std::shared_ptr<const Version::Delta> delta) {
+        auto version = std::make_shared<Version>();
+        version->epoch = this->current ? this->current->epoch + 1 : 0;
+        version->base = std::move(base);
+        version->delta = std::move(delta);
+
+        std::atomic_store(&this->current, std::shared_ptr<const Version>(std::move(version)));
+    }
+
+    void VersionedGraph::commit(Write write) {
+        auto delta = std::make_shared<Version::Delta>(*this->current->delta);
+        write(*this->current->base, *delta);
+        delta->writes++;
+
+        if (this->merging) this->pending.push_back(std::move(write));
+        auto full = delta->writes >= this->merge_threshold;
+        publish(this->current->base, std::move(delta));
+
+        if (full && !this->merging) start_merge();
+    }
+
+    void VersionedGraph::start_merge() {
+        if (this->merger.joinable()) this->merger.join();
+
+        this->merging = true;
+        this->merger = std::thread([this, version = this->current]() {
+            auto base = std::make_shared<const Version::Base>(*version, !this->weight_property.empty());
+
+            std::lock_guard<std::mutex> lock(this->writers);
+            auto delta = std::make_shared<Version::Delta>();
+            for (auto& write : this->pending) {
+                write(*base, *delta);
+                delta->writes++;
+            }
+            this->pending.clear();
+            this->merging = false;
+
+            publish(std::move(base), std::move(delta));
+            this->merged.notify_all();
+        });
+    }
+
+    VersionedGraph::~VersionedGraph() {
+        if (this->merger.joinable()) this->merger.join();
+    }
+
+    bool VersionedGraph::add(const std::string& name, std::shared_ptr<Type> type) {
+        std::lock_guard<std::mutex> lock(this->writers);
+        if (this->graph->vertices.count(name)) return false;
+
+        auto vertex = this->graph->add(name, std::move(type));
+
+        commit([name, vertex](const Version::Base& base, Version::Delta& delta) {
+            delta.ids.set(name, base.snapshot.size() + delta.added.size());
+            delta.added.push_back({name, vertex->type_id, vertex});
+        });
+        return true;
+    }
+
+    bool VersionedGraph::link(const std::string& from, const std::string& to, bool undirected, const std::map<std::string, std::any>& properties) {
+        double weight = 1.0;
+        if (!this->weight_property.empty()) {
+            auto it = properties.find(this->weight_property);
+            if (it == properties.end() || !any_to_double(&it->second, weight)) {
+                throw std::invalid_argument("edge " + from + " -> " + to + " has no numeric property " + this->weight_property);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(this->writers);
+        if (!this->graph->vertices.count(from) || !this->graph->vertices.count(to)) return false;
+
+        auto& connections = this->graph->vertices[from]->connections;
+        auto first = connections.size();
+        *this->graph->link(from, to, undirected) = properties;
+
+        std::shared_ptr<Edge> forward = connections[first];
+        std::shared_ptr<Edge> backward = forward->reverse.lock();
+
+        commit([from, to, weight, forward, backward](const Version::Base& base, Version::Delta& delta) {
+            auto id = [&](const std::string& name) {
+                auto it = base.snapshot.ids.find(name);
+                return it != base.snapshot.ids.end() ? it->second : *delta.ids.find(name);
+            };
+
+            auto append = [&](std::size_t source, std::size_t target, const std::shared_ptr<Edge>& edge) {
+                auto existing = delta.arcs.find(source);
+                auto arcs = existing ? *existing : SharedLog<Arc>();
+                arcs.push_back({target, weight, base.snapshot.targets.size() + delta.edges.size()});
+                delta.edges.push_back(edge);
+                delta.arcs.set(source, std::move(arcs));
+            };
+
+            auto source = id(from), target = id(to);
+            append(source, target, forward);
+            if (backward) append(target, source, backward);
+        });
+        return true;
+    }
+
+    bool VersionedGraph::add_prop(const std::string& vertex, const std::string& key, std::any value) {
+        std::lock_guard<std::mutex> lock(this->writers);
+        if (!this->graph->vertices.count(vertex)) return false;
+
+        auto& properties = this->graph->get_vertex(vertex)->properties;
+        properties.set(key, std::move(value));
+
+        auto now = std::make_shared<const PropertyMap::map_type>(properties.begin(), properties.end());
+        commit([vertex, now](const Version::Base& base, Version::Delta& delta) {
+            auto it = base.snapshot.ids.find(vertex);
+            delta.properties.set(it != base.snapshot.ids.end() ? it->second : *delta.ids.find(vertex), now);
+        });
+        return true;
+    }
+
+    void VersionedGraph::merge() {
+        std::unique_lock<std::mutex> lock(this->writers);
+        this->merged.wait(lock, [this]() { return !this->merging; });
+        publish(std::make_shared<const Version::Base>(*this->current, !this->weight_property.empty()), std::make_shared<Version::Delta>());
+    }
+}
@@ -0,0 +1,175 @@
+#ifndef TINYGRAPH_VERSIONED_H
+#define TINYGRAPH_VERSIONED_H
+
+#include "graph.h"
+#include "persistent.h"
+#include "snapshot.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace tinygraph {
+    // A graph that can be queried while it is being written. Readers pin() an
+    // immutable Version and run their queries on it; writers go through add, link and
+    // add_prop, which update the owned Graph and publish a new Version without ever
+    // waiting for a reader.
+    //
+    // A Version is a base Snapshot plus a delta of what was written since that base
+    // was taken. The delta is made of persistent maps and logs, so a write copies a
+    // few nodes and shares the rest with the versions before it. Once the delta holds
+    // `merge_threshold` writes, a background thread folds a pinned version into a
+    // fresh base; the writes made meanwhile are replayed onto it when it is published,
+    // and writers carry on in the meantime. Versions are reference counted: an old
+    // one is freed when the last reader that pinned it lets go, and publishing never
+    // has to wait for that to happen.
+    class VersionedGraph {
+    public:
+        class Version;
+
+        explicit VersionedGraph(std::unique_ptr<Graph> graph, const std::string& weight_property = "", std::size_t merge_threshold = 1024);
+
+        VersionedGraph(const VersionedGraph&) = delete;
+        VersionedGraph& operator=(const VersionedGraph&) = delete;
+
+        // Waits for a running merge.
+        ~VersionedGraph();
+
+        // The current version. It does not change while it is held.
+        std::shared_ptr<const Version> pin() const;
+
+        // False if a vertex of that name exists already.
+        bool add(const std::string& name, std::shared_ptr<Type> type);
+
+        // Same as Graph::link, with the edge properties given up front so that readers
+        // never see an edge without its weight. False if either vertex does not exist;
+        // throws std::invalid_argument if the weight property is missing or not a number.
+        bool link(const std::string& from, const std::string& to, bool undirected, const std::map<std::string, std::any>& properties = {});
+
+        // False if there is no such vertex.
+        bool add_prop(const std::string& vertex, const std::string& key, std::any value);
+
+        // Waits for a running merge, then folds the pending writes into a new base
+        // right away.
+        void merge();
+
+        class Version {
+        public:
+            class ArcIterator {
+            public:
+                ArcIterator(const Version* version, std::size_t vertex, std::size_t position) : version(version), vertex(vertex), position(position) { }
+
+                Arc operator*() const;
+
+                ArcIterator& operator++() {
+                    position++;
+                    return *this;
+                }
+
+                bool operator!=(const ArcIterator& other) const { return position != other.position; }
+                bool operator==(const ArcIterator& other) const { return position == other.position; }
+
+            private:
+                const Version* version;
+                std::size_t vertex;
+                std::size_t position;
+            };
+
+            struct Arcs {
+                ArcIterator first;
+                ArcIterator last;
+
+                ArcIterator begin() const { return first; }
+                ArcIterator end() const { return last; }
+            };
+
+            // Vertices of the base come first in its order, then the ones added since.
+            // Merging keeps that order, so a vertex's id never changes.
+            Arcs neighbours(std::size_t vertex) const;
+
+            std::size_t size() const;
+
+            // Throws std::out_of_range for unknown names, like Snapshot::id.
+            std::size_t id(const std::string& name) const;
+
+            const std::string& name(std::size_t vertex) const;
+
+            std::uint32_t type_id(std::size_t vertex) const;
+
+            // nullptr if the vertex had no such property in this version.
+            const std::any* property(std::size_t vertex, const std::string& key) const;
+
+            // Increases by one with every published version.
+            std::uint64_t epoch = 0;
+
+        private:
+            friend class VersionedGraph;
+
+            struct Base {
+                Base(Graph& graph, const std::string& weight_property);
+
+                // The version's base and delta in one snapshot, with the delta's
+                // vertices and arcs after the base's.
+                Base(const Version& version, bool weighted);
+
+                Snapshot snapshot;
+                std::vector<std::shared_ptr<const PropertyMap::map_type>> properties;
+            };
+
+            struct Added {
+                std::string name;
+                std::uint32_t type_id = Type::unregistered;
+                std::shared_ptr<Vertex> vertex;
+            };
+
+            // Copying a delta copies handles only; the two copies share everything.
+            struct Delta {
+                SharedLog<Added> added;
+                PersistentMap<std::string, std::size_t> ids;
+                // arcs added to a vertex, base or new, by vertex id
+                PersistentMap<std::size_t, SharedLog<Arc>> arcs;
+                // edges of the added arcs; an arc's edge id is the base's edge count
+                // plus its position here
+                SharedLog<std::shared_ptr<Edge>> edges;
+                PersistentMap<std::size_t, std::shared_ptr<const PropertyMap::map_type>> properties;
+                std::size_t writes = 0;
+            };
+
+            std::size_t base_degree(std::size_t vertex) const;
+
+            const SharedLog<Arc>* extra_arcs(std::size_t vertex) const;
+
+            std::shared_ptr<const Base> base;
+            std::shared_ptr<const Delta> delta;
+        };
+
+    private:
+        // One write, applied to a delta on top of the given base.
+        using Write = std::function<void(const Version::Base&, Version::Delta&)>;
+
+        // Publishes the current delta with the write applied, remembers the write if a
+        // merge is running, and starts one once the delta is full.
+        void commit(Write write);
+
+        void start_merge();
+
+        void publish(std::shared_ptr<const Version::Base> base, std::shared_ptr<const Version::Delta> delta);
+
+        std::unique_ptr<Graph> graph;
+        std::string weight_property;
+        std::size_t merge_threshold;
+
+        std::mutex writers;
+        std::shared_ptr<const Version> current;
+
+        // writes made since the running merge pinned its version
+        std::vector<Write> pending;
+        bool merging = false;
+        std::condition_variable merged;
+        std::thread merger;
+    };
+}
+
+#endif //TINYGRAPH_VERSIONED_H
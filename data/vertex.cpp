@@ -3,14 +3,142 @@
 //
 
 #include "types.h"
+#include <algorithm>
 #include <utility>
 
 namespace tinygraph {
-    Vertex::Vertex(std::string name, std::shared_ptr<Type> type) : name(std::move(name)), type(std::move(type)) { }
+    Vertex::Vertex(std::string name, std::shared_ptr<Type> type) : name(std::move(name)), type(std::move(type)), properties(this) {
+        this->type_id = this->type ? this->type->id : Type::unregistered;
+    }
+
+    Vertex::Vertex(const Vertex& other)
+            : std::enable_shared_from_this<Vertex>(), name(other.name), type(other.type), type_id(other.type_id), connections(other.connections),
+              properties(this, other.properties), edges_to(other.edges_to), edges_indexed(other.edges_indexed), removed(other.removed) { }
+
+    Vertex& Vertex::operator=(const Vertex& other) {
+        if (this == &other) return *this;
+
+        this->name = other.name;
+        this->type = other.type;
+        this->type_id = other.type_id;
+        this->connections = other.connections;
+        this->edges_to = other.edges_to;
+        this->edges_indexed = other.edges_indexed;
+        this->properties.assign(other.properties);
+        this->removed = other.removed;
+        return *this;
+    }
 
     Vertex::~Vertex() = default;
 
+    void Vertex::add_observer(PropertyObserver* observer) {
+        if (std::find(this->observers.begin(), this->observers.end(), observer) == this->observers.end()) this->observers.push_back(observer);
+    }
+
+    void Vertex::remove_observer(PropertyObserver* observer) {
+        this->observers.erase(std::remove(this->observers.begin(), this->observers.end(), observer), this->observers.end());
+    }
+
+    void Vertex::connect(std::shared_ptr<Edge> edge) {
+        if (this->edges_indexed) this->edges_to.emplace(edge->to.get(), edge.get());
+        this->connections.push_back(std::move(edge));
+    }
+
+    std::vector<Edge*> Vertex::edges_into(const Vertex* to) {
+        std::vector<Edge*> res;
+
+        if (!this->edges_indexed && this->connections.size() <= index_degree) {
+            for (auto& edge : this->connections) {
+                if (edge->to.get() == to) res.push_back(edge.get());
+            }
+            return res;
+        }
+
+        if (!this->edges_indexed) {
+            this->edges_to.reserve(this->connections.size());
+            for (auto& edge : this->connections) this->edges_to.emplace(edge->to.get(), edge.get());
+            this->edges_indexed = true;
+        }
+
+        auto range = this->edges_to.equal_range(to);
+        for (auto it = range.first; it != range.second; ++it) res.push_back(it->second);
+        return res;
+    }
+
+    std::size_t Vertex::drop_dead_edges() {
+        // edges_to holds raw pointers, so its entries go while `connections` still owns
+        // the edges
+        for (auto it = this->edges_to.begin(); it != this->edges_to.end();) {
+            if (it->second->live()) ++it;
+            else it = this->edges_to.erase(it);
+        }
+
+        auto before = this->connections.size();
+        this->connections.erase(std::remove_if(this->connections.begin(), this->connections.end(), [](const std::shared_ptr<Edge>& edge) {
+            return !edge->live();
+        }), this->connections.end());
+
+        auto dropped = before - this->connections.size();
+        if (this->connections.capacity() > 2 * this->connections.size()) this->connections.shrink_to_fit();
+        return dropped;
+    }
+
     void Vertex::add_prop(const char* key, std::any value) {
-        this->properties[key] = std::move(value);
+        this->properties.set(key, std::move(value));
+    }
+
+    void PropertyMap::set(const std::string& key, std::any value) {
+        auto it = values.find(key);
+
+        if (vertex->observers.empty()) {
+            if (it == values.end()) values.emplace(key, std::move(value));
+            else it->second = std::move(value);
+            return;
+        }
+
+        if (it == values.end()) {
+            it = values.emplace(key, std::move(value)).first;
+            notify(key, nullptr, &it->second);
+        } else {
+            auto before = std::move(it->second);
+            it->second = std::move(value);
+            notify(key, &before, &it->second);
+        }
+    }
+
+    std::pair<PropertyMap::map_type::const_iterator, bool> PropertyMap::insert(map_type::value_type value) {
+        auto res = values.insert(std::move(value));
+        if (res.second) notify(res.first->first, nullptr, &res.first->second);
+        return res;
+    }
+
+    void PropertyMap::assign(const PropertyMap& other) {
+        if (this == &other) return;
+
+        for (auto it = values.begin(); it != values.end();) {
+            auto key = (it++)->first;
+            if (!other.count(key)) erase(key);
+        }
+        for (const auto& [key, value] : other) set(key, value);
+    }
+
+    bool PropertyMap::erase(const std::string& key) {
+        auto it = values.find(key);
+        if (it == values.end()) return false;
+
+        auto before = std::move(it->second);
+        values.erase(it);
+        notify(key, &before, nullptr);
+        return true;
+    }
+
+    void PropertyMap::notify(const std::string& key, const std::any* before, const std::any* after) {
+        for (auto* observer : vertex->observers) observer->property_changed(*vertex, key, before, after);
+    }
+
+    const std::any& PropertyMap::Reference::get() const {
+        map_type::const_iterator it = owner->values.find(key);
+        if (it == owner->values.end()) it = owner->insert({key, std::any()}).first;
+        return it->second;
     }
 }
@@ -0,0 +1,295 @@
+#include "apsp.h"
+#include "parallel.h"
+#include "traversal.h"
+#include <data/snapshot.h>
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TINYGRAPH_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace tinygraph {
+    namespace {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        // 64 x 64 doubles is 32 KiB, so the three blocks of an update stay in L2
+        constexpr std::size_t block = 64;
+
+        // One Floyd-Warshall step over a block: for every k of the pivot block, row i
+        // of block (i0, j0) is relaxed through (i, k) and row k of block (k0, j0).
+        // `next` may be null.
+        void relax_block_scalar(double* d, std::int64_t* next, std::size_t stride, std::size_t i0, std::size_t j0, std::size_t k0) {
+            for (auto k = k0; k < k0 + block; k++) {
+                const double* row_k = d + k * stride;
+
+                for (auto i = i0; i < i0 + block; i++) {
+                    double* row_i = d + i * stride;
+                    auto through = row_i[k];
+                    if (through == infinity) continue;
+
+                    for (auto j = j0; j < j0 + block; j++) {
+                        auto candidate = through + row_k[j];
+                        if (candidate < row_i[j]) {
+                            row_i[j] = candidate;
+                            if (next) next[i * stride + j] = next[i * stride + k];
+                        }
+                    }
+                }
+            }
+        }
+
+#ifdef TINYGRAPH_X86_SIMD
+        __attribute__((target("avx2")))
+        void relax_block_avx2(double* d, std::int64_t* next, std::size_t stride, std::size_t i0, std::size_t j0, std::size_t k0) {
+            for (auto k = k0; k < k0 + block; k++) {
+                const double* row_k = d + k * stride;
+
+                for (auto i = i0; i < i0 + block; i++) {
+                    double* row_i = d + i * stride;
+                    auto through = row_i[k];
+                    if (through == infinity) continue;
+
+                    auto vthrough = _mm256_set1_pd(through);
+                    if (!next) {
+                        for (auto j = j0; j < j0 + block; j += 4) {
+                            auto candidate = _mm256_add_pd(vthrough, _mm256_loadu_pd(row_k + j));
+                            _mm256_storeu_pd(row_i + j, _mm256_min_pd(_mm256_loadu_pd(row_i + j), candidate));
+                        }
+                        continue;
+                    }
+
+                    // next hops are 64 bit so that they can be blended with the same mask
+                    auto* hops = reinterpret_cast<double*>(next + i * stride);
+                    auto vhop = _mm256_castsi256_pd(_mm256_set1_epi64x(next[i * stride + k]));
+                    for (auto j = j0; j < j0 + block; j += 4) {
+                        auto current = _mm256_loadu_pd(row_i + j);
+                        auto candidate = _mm256_add_pd(vthrough, _mm256_loadu_pd(row_k + j));
+                        auto better = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+
+                        _mm256_storeu_pd(row_i + j, _mm256_blendv_pd(current, candidate, better));
+                        _mm256_storeu_pd(hops + j, _mm256_blendv_pd(_mm256_loadu_pd(hops + j), vhop, better));
+                    }
+                }
+            }
+        }
+#endif
+
+        using relax_fn = void (*)(double*, std::int64_t*, std::size_t, std::size_t, std::size_t, std::size_t);
+
+        relax_fn pick() {
+#ifdef TINYGRAPH_X86_SIMD
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return relax_block_avx2;
+#endif
+            return relax_block_scalar;
+        }
+
+        bool floyd_warshall(const Snapshot& snapshot, DistanceMatrix& matrix, bool next_hops, const CancellationToken& token) {
+            static const relax_fn relax = pick();
+
+            auto n = snapshot.size();
+            auto blocks = (n + block - 1) / block;
+            auto stride = blocks * block;
+
+            // padding rows and columns stay infinite and never shorten anything
+            std::vector<double> d(stride * stride, infinity);
+            std::vector<std::int64_t> next(next_hops ? stride * stride : 0, -1);
+            auto* hops = next_hops ? next.data() : nullptr;
+
+            for (std::size_t v = 0; v < n; v++) {
+                d[v * stride + v] = 0;
+                if (hops) hops[v * stride + v] = v;
+
+                for (auto arc : snapshot.neighbours(v)) {
+                    auto& current = d[v * stride + arc.to];
+                    if (arc.weight < current) {
+                        current = arc.weight;
+                        if (hops) hops[v * stride + arc.to] = arc.to;
+                    }
+                }
+            }
+
+            for (std::size_t kb = 0; kb < blocks; kb++) {
+                token.check();
+                auto k0 = kb * block;
+                relax(d.data(), hops, stride, k0, k0, k0);
+
+                // the pivot row and column only depend on the pivot block
+                parallel_for(0, 2 * blocks, [&](std::size_t lo, std::size_t hi) {
+                    for (auto b = lo; b < hi; b++) {
+                        auto other = (b % blocks) * block;
+                        if (other == k0) continue;
+                        if (b < blocks) relax(d.data(), hops, stride, k0, other, k0);
+                        else relax(d.data(), hops, stride, other, k0, k0);
+                    }
+                }, 1);
+
+                // and every other block only on the pivot row and column
+                parallel_for(0, blocks * blocks, [&](std::size_t lo, std::size_t hi) {
+                    for (auto b = lo; b < hi; b++) {
+                        auto i0 = (b / blocks) * block, j0 = (b % blocks) * block;
+                        if (i0 == k0 || j0 == k0) continue;
+                        relax(d.data(), hops, stride, i0, j0, k0);
+                    }
+                }, 1);
+            }
+
+            for (std::size_t v = 0; v < n; v++) {
+                if (d[v * stride + v] < 0) return false;
+            }
+
+            matrix.distance.resize(n * n);
+            if (next_hops) matrix.next.resize(n * n);
+            for (std::size_t i = 0; i < n; i++) {
+                std::copy_n(d.begin() + i * stride, n, matrix.distance.begin() + i * n);
+                if (next_hops) std::copy_n(next.begin() + i * stride, n, matrix.next.begin() + i * n);
+            }
+            return true;
+        }
+
+        // Snapshot arcs with Johnson's potentials applied, which makes every weight
+        // non-negative (up to rounding, hence the clamp).
+        class Reweighted {
+        public:
+            Reweighted(const Snapshot& snapshot, const std::vector<double>& potential) : snapshot(snapshot), potential(potential) { }
+
+            class ArcIterator {
+            public:
+                ArcIterator(const Reweighted* owner, std::size_t from, Snapshot::ArcIterator at) : owner(owner), from(from), at(at) { }
+
+                Arc operator*() const {
+                    auto arc = *at;
+                    arc.weight = std::max(0.0, arc.weight + owner->potential[from] - owner->potential[arc.to]);
+                    return arc;
+                }
+
+                ArcIterator& operator++() {
+                    ++at;
+                    return *this;
+                }
+
+                bool operator!=(const ArcIterator& other) const { return at != other.at; }
+
+            private:
+                const Reweighted* owner;
+                std::size_t from;
+                Snapshot::ArcIterator at;
+            };
+
+            struct Arcs {
+                ArcIterator first;
+                ArcIterator last;
+
+                ArcIterator begin() const { return first; }
+                ArcIterator end() const { return last; }
+            };
+
+            std::size_t size() const { return snapshot.size(); }
+
+            Arcs neighbours(std::size_t v) const {
+                auto arcs = snapshot.neighbours(v);
+                return {ArcIterator(this, v, arcs.begin()), ArcIterator(this, v, arcs.end())};
+            }
+
+        private:
+            const Snapshot& snapshot;
+            const std::vector<double>& potential;
+        };
+
+        bool johnson(const Snapshot& snapshot, DistanceMatrix& matrix, bool next_hops, const CancellationToken& token) {
+            auto n = snapshot.size();
+
+            // Bellman-Ford from a virtual vertex with a zero edge to every vertex
+            std::vector<double> potential(n, 0);
+            bool relaxed = true;
+            for (std::size_t pass = 0; pass <= n && relaxed; pass++) {
+                token.check();
+                relaxed = false;
+                for (std::size_t v = 0; v < n; v++) {
+                    for (auto arc : snapshot.neighbours(v)) {
+                        if (potential[v] + arc.weight < potential[arc.to]) {
+                            potential[arc.to] = potential[v] + arc.weight;
+                            relaxed = true;
+                        }
+                    }
+                }
+            }
+            if (relaxed) return false;
+
+            Reweighted reweighted(snapshot, potential);
+            matrix.distance.assign(n * n, infinity);
+            if (next_hops) matrix.next.assign(n * n, -1);
+
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                std::vector<std::size_t> first(n);
+
+                for (auto source = lo; source < hi; source++) {
+                    token.check();
+                    auto paths = dijkstra(reweighted, source, AllVertices(), token);
+                    auto* row = matrix.distance.data() + source * n;
+
+                    for (std::size_t v = 0; v < n; v++) {
+                        if (paths.distance[v] != infinity) row[v] = paths.distance[v] - potential[source] + potential[v];
+                    }
+                    if (!next_hops) continue;
+
+                    // the first hop of v is its parent's first hop, found by walking up
+                    // to a vertex whose first hop is known
+                    std::fill(first.begin(), first.end(), unreachable);
+                    first[source] = source;
+                    for (std::size_t v = 0; v < n; v++) {
+                        if (paths.distance[v] == infinity) continue;
+
+                        auto u = v;
+                        while (first[u] == unreachable && paths.parent[u] != source) u = paths.parent[u];
+                        auto hop = first[u] != unreachable ? first[u] : u;
+                        for (u = v; first[u] == unreachable; u = paths.parent[u]) first[u] = hop;
+
+                        matrix.next[source * n + v] = first[v];
+                    }
+                }
+            }, 16);
+
+            return true;
+        }
+    }
+
+    double DistanceMatrix::at(std::size_t from, std::size_t to) const {
+        return distance[from * size + to];
+    }
+
+    std::vector<std::size_t> DistanceMatrix::path(std::size_t from, std::size_t to) const {
+        std::vector<std::size_t> res;
+        if (next.empty() || next[from * size + to] < 0) return res;
+
+        res.push_back(from);
+        while (from != to) {
+            from = next[from * size + to];
+            res.push_back(from);
+        }
+        return res;
+    }
+
+    bool all_pairs_shortest_paths(const Snapshot& snapshot, DistanceMatrix& matrix, bool next_hops, ApspMethod method, const CancellationToken& token) {
+        auto n = snapshot.size();
+        matrix.size = n;
+        matrix.names = snapshot.names;
+        matrix.next.clear();
+
+        if (method == ApspMethod::automatic) {
+            method = snapshot.targets.size() * 16 < n * n ? ApspMethod::johnson : ApspMethod::floyd_warshall;
+        }
+
+        return method == ApspMethod::johnson ? johnson(snapshot, matrix, next_hops, token) : floyd_warshall(snapshot, matrix, next_hops, token);
+    }
+
+    bool all_pairs_shortest_paths(Graph& graph, const std::string& weight_property, DistanceMatrix& matrix, bool next_hops, ApspMethod method, const CancellationToken& token) {
+        Snapshot snapshot(graph, weight_property);
+
+        auto res = all_pairs_shortest_paths(snapshot, matrix, next_hops, method, token);
+        graph.negative_cycle = res ? Graph::non_negative : Graph::negative;
+        return res;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TINYGRAPH_APSP_H
+#define TINYGRAPH_APSP_H
+
+#include "cancellation.h"
+#include <data/graph.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Snapshot;
+
+    // Row-major matrix over snapshot vertex ids; distance[i * size + j] is infinity when
+    // j cannot be reached from i.
+    struct DistanceMatrix {
+        std::size_t size = 0;
+        std::vector<std::string> names;
+        std::vector<double> distance;
+        // next[i * size + j] is the vertex after i on a shortest path to j (j itself
+        // for a direct edge, i for i == j), -1 if there is none. Empty unless next hops
+        // were asked for.
+        std::vector<std::int64_t> next;
+
+        double at(std::size_t from, std::size_t to) const;
+
+        // Vertex ids from `from` to `to`, empty if unreachable or without next hops.
+        std::vector<std::size_t> path(std::size_t from, std::size_t to) const;
+    };
+
+    // floyd_warshall is cache blocked (and AVX2 vectorized where the CPU has it), with
+    // the blocks of every round spread over the thread pool; johnson reweights with one
+    // Bellman-Ford pass and runs a Dijkstra per source in parallel. automatic picks
+    // Johnson for sparse graphs and Floyd-Warshall for dense ones.
+    enum class ApspMethod { automatic, floyd_warshall, johnson };
+
+    // Distances between all pairs of vertices of a snapshot, which must have been built
+    // with a weight property. Returns false, leaving the matrix unspecified, if the
+    // graph has a negative cycle. The token is checked once per pivot block or source.
+    bool all_pairs_shortest_paths(const Snapshot& snapshot, DistanceMatrix& matrix, bool next_hops = false, ApspMethod method = ApspMethod::automatic,
+                                  const CancellationToken& token = CancellationToken::never());
+
+    // Same, with vertices in Graph::vertices order. Sets graph.negative_cycle the way
+    // bellman_ford does. Throws std::invalid_argument if some edge has no int, float
+    // or double weight_property.
+    bool all_pairs_shortest_paths(Graph& graph, const std::string& weight_property, DistanceMatrix& matrix, bool next_hops = false, ApspMethod method = ApspMethod::automatic,
+                                  const CancellationToken& token = CancellationToken::never());
+}
+
+#endif //TINYGRAPH_APSP_H
@@ -0,0 +1,11 @@
+#include "async.h"
+#include <algorithm>
+#include <thread>
+
+namespace tinygraph {
+    Executor::Executor(std::size_t threads) : pool(threads ? threads : std::max(std::thread::hardware_concurrency(), 1u)) { }
+
+    std::size_t Executor::size() const {
+        return pool.size();
+    }
+}
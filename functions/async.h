@@ -0,0 +1,163 @@
+#ifndef TINYGRAPH_ASYNC_H
+#define TINYGRAPH_ASYNC_H
+
+#include "cancellation.h"
+#include "parallel.h"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace tinygraph {
+    namespace detail {
+        template<typename T>
+        struct QueryState {
+            std::mutex mutex;
+            std::condition_variable finished;
+            // the value or error is set; a continuation installed from now on runs
+            // right away instead of being stored
+            bool settled = false;
+            // settled and the stored continuation, if any, has returned
+            bool done = false;
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::function<void()> continuation;
+
+            void finish() {
+                std::function<void()> next;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    settled = true;
+                    next = std::move(continuation);
+                }
+                // wakes get(), which a continuation may call itself
+                finished.notify_all();
+                if (next) next();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done = true;
+                }
+                finished.notify_all();
+            }
+        };
+    }
+
+    // The pending result of a query submitted to an Executor. Works like a
+    // std::future (get() waits and rethrows, Cancelled included) and is also an
+    // awaitable, so a C++20 coroutine can `co_await` it: the coroutine resumes on the
+    // executor thread that finished the query.
+    template<typename T>
+    class Query {
+    public:
+        Query(std::shared_ptr<detail::QueryState<T>> state, CancellationToken token) : state(std::move(state)), cancellation(std::move(token)) { }
+
+        // Asks the query to stop; it finishes with Cancelled at the algorithm's next check.
+        void cancel() const { cancellation.cancel(); }
+
+        const CancellationToken& token() const { return cancellation; }
+
+        bool ready() const {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            return state->done;
+        }
+
+        // Returns once the query is done and its continuation, if any, has run.
+        void wait() const {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->finished.wait(lock, [this]() { return state->done; });
+        }
+
+        template<typename Rep, typename Period>
+        bool wait_for(std::chrono::duration<Rep, Period> timeout) const {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            return state->finished.wait_for(lock, timeout, [this]() { return state->done; });
+        }
+
+        // Waits for the result and moves it out; call once. Unlike wait() it does not
+        // wait for the continuation, so the continuation may call it.
+        T get() {
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->finished.wait(lock, [this]() { return state->settled; });
+            }
+            if (state->error) std::rethrow_exception(state->error);
+            return std::move(*state->value);
+        }
+
+        // Runs f() once the query is done, right away if it already is.
+        template<typename F>
+        void then(F f) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->settled) {
+                    state->continuation = std::move(f);
+                    return;
+                }
+            }
+            f();
+        }
+
+        bool await_ready() const { return ready(); }
+
+        // Templated on the handle so that this header needs no <coroutine>.
+        template<typename Handle>
+        bool await_suspend(Handle handle) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->settled) return false;
+
+            state->continuation = [handle]() mutable { handle.resume(); };
+            return true;
+        }
+
+        T await_resume() { return get(); }
+
+    private:
+        std::shared_ptr<detail::QueryState<T>> state;
+        CancellationToken cancellation;
+    };
+
+    // Runs queries on its own threads, apart from the default pool that the parallel
+    // algorithms use inside a query. A query is any callable taking the query's
+    // CancellationToken, which it should pass on to the algorithms it calls. Queries
+    // still queued when the executor is destroyed run first (and fail fast if their
+    // token is cancelled).
+    class Executor {
+    public:
+        // threads = 0 uses one per hardware thread.
+        explicit Executor(std::size_t threads = 0);
+
+        // Pass CancellationToken::after(timeout) or a token with a deadline to bound
+        // the query; it fails with Cancelled without starting if the token is already
+        // cancelled when its turn comes.
+        template<typename F>
+        auto submit(F query, CancellationToken token = CancellationToken()) -> Query<std::invoke_result_t<F, const CancellationToken&>> {
+            using result_type = std::invoke_result_t<F, const CancellationToken&>;
+            static_assert(!std::is_void<result_type>::value, "queries must return their result");
+
+            auto state = std::make_shared<detail::QueryState<result_type>>();
+            pool.post([state, token, query = std::move(query)]() mutable {
+                try {
+                    token.check();
+                    state->value.emplace(query(static_cast<const CancellationToken&>(token)));
+                } catch (...) {
+                    state->error = std::current_exception();
+                }
+                state->finish();
+            });
+
+            return {state, std::move(token)};
+        }
+
+        std::size_t size() const;
+
+    private:
+        ThreadPool pool;
+    };
+}
+
+#endif //TINYGRAPH_ASYNC_H
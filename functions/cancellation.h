@@ -0,0 +1,74 @@
+#ifndef TINYGRAPH_CANCELLATION_H
+#define TINYGRAPH_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+namespace tinygraph {
+    // Thrown by algorithms that notice their token was cancelled or ran past its deadline.
+    class Cancelled : public std::runtime_error {
+    public:
+        Cancelled() : std::runtime_error("query cancelled") { }
+    };
+
+    // Shared between whoever may cancel a query and the algorithm running it; copies
+    // refer to the same state. Algorithms call check() at pass or frontier boundaries.
+    class CancellationToken {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        // Cancelled only through cancel().
+        CancellationToken() : state(std::make_shared<State>()) { }
+
+        // Also cancelled once the deadline has passed.
+        explicit CancellationToken(clock::time_point deadline) : state(std::make_shared<State>()) {
+            state->deadline = deadline;
+            state->has_deadline = true;
+        }
+
+        template<typename Rep, typename Period>
+        static CancellationToken after(std::chrono::duration<Rep, Period> timeout) {
+            return CancellationToken(clock::now() + std::chrono::duration_cast<clock::duration>(timeout));
+        }
+
+        // A token that can never be cancelled and costs nothing to check; the default
+        // for algorithms called without one.
+        static const CancellationToken& never() {
+            static const CancellationToken token(nullptr);
+            return token;
+        }
+
+        void cancel() const {
+            if (state) state->cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        bool cancelled() const {
+            if (!state) return false;
+            if (state->cancelled.load(std::memory_order_relaxed)) return true;
+            if (state->has_deadline && clock::now() >= state->deadline) {
+                state->cancelled.store(true, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        void check() const {
+            if (cancelled()) throw Cancelled();
+        }
+
+    private:
+        struct State {
+            std::atomic<bool> cancelled{false};
+            bool has_deadline = false;
+            clock::time_point deadline;
+        };
+
+        explicit CancellationToken(std::nullptr_t) { }
+
+        std::shared_ptr<State> state;
+    };
+}
+
+#endif //TINYGRAPH_CANCELLATION_H
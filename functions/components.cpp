@@ -0,0 +1,337 @@
+#include "components.h"
+#include "parallel.h"
+
+#include <data/graph.h>
+#include <data/snapshot.h>
+#include <data/subgraph.h>
+#include <type/type_store.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace tinygraph {
+    namespace {
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+        // Iterative Tarjan over the subgraph induced by `members`. in_set(w) tells whether
+        // an edge target belongs to that subgraph and local(w) maps a member to its
+        // position in `members`. emit receives each component as soon as it is complete.
+        template<typename Adjacency, typename InSet, typename Local, typename Emit>
+        void tarjan(const Adjacency& adjacency, const std::vector<std::size_t>& members, InSet in_set, Local local, Emit emit) {
+            using iterator = decltype(adjacency.neighbours(0).begin());
+
+            struct Frame {
+                std::size_t vertex;
+                iterator next;
+                iterator last;
+            };
+
+            std::vector<std::size_t> index(members.size(), none);
+            std::vector<std::size_t> low(members.size());
+            std::vector<bool> on_stack(members.size(), false);
+
+            std::vector<std::size_t> stack;
+            std::vector<Frame> calls;
+            std::size_t counter = 0;
+
+            auto visit = [&](std::size_t v) {
+                auto lv = local(v);
+                index[lv] = low[lv] = counter++;
+                on_stack[lv] = true;
+                stack.push_back(v);
+
+                auto arcs = adjacency.neighbours(v);
+                calls.push_back({v, arcs.begin(), arcs.end()});
+            };
+
+            for (auto root : members) {
+                if (index[local(root)] != none) continue;
+
+                visit(root);
+
+                while (!calls.empty()) {
+                    auto& frame = calls.back();
+                    auto v = frame.vertex;
+                    auto lv = local(v);
+
+                    if (frame.next != frame.last) {
+                        auto w = (*frame.next).to;
+                        ++frame.next;
+                        if (!in_set(w)) continue;
+
+                        auto lw = local(w);
+                        if (index[lw] == none) {
+                            visit(w);
+                        } else if (on_stack[lw]) {
+                            low[lv] = std::min(low[lv], index[lw]);
+                        }
+                        continue;
+                    }
+
+                    if (low[lv] == index[lv]) {
+                        std::vector<std::size_t> component;
+                        std::size_t w;
+                        do {
+                            w = stack.back();
+                            stack.pop_back();
+                            on_stack[local(w)] = false;
+                            component.push_back(w);
+                        } while (w != v);
+                        emit(component);
+                    }
+
+                    calls.pop_back();
+                    if (!calls.empty()) {
+                        auto parent = local(calls.back().vertex);
+                        low[parent] = std::min(low[parent], low[lv]);
+                    }
+                }
+            }
+        }
+
+        // Level-synchronous parallel sweep from `frontier`; claim(w) decides (atomically)
+        // whether w joins the sweep.
+        template<typename Claim>
+        void sweep(const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& targets, std::vector<std::size_t> frontier, Claim claim) {
+            std::mutex mutex;
+
+            while (!frontier.empty()) {
+                std::vector<std::size_t> next;
+
+                parallel_for(0, frontier.size(), [&](std::size_t lo, std::size_t hi) {
+                    std::vector<std::size_t> found;
+                    for (auto i = lo; i < hi; i++) {
+                        auto v = frontier[i];
+                        for (auto e = offsets[v]; e < offsets[v + 1]; e++) {
+                            if (claim(targets[e])) found.push_back(targets[e]);
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    next.insert(next.end(), found.begin(), found.end());
+                }, 256);
+
+                frontier.swap(next);
+            }
+        }
+    }
+
+    Components strongly_connected_components(const Snapshot& snapshot) {
+        Components result;
+        result.component.assign(snapshot.size(), none);
+
+        std::vector<std::size_t> members(snapshot.size());
+        for (std::size_t v = 0; v < members.size(); v++) members[v] = v;
+
+        tarjan(snapshot, members,
+               [](std::size_t) { return true; },
+               [](std::size_t v) { return v; },
+               [&result](const std::vector<std::size_t>& component) {
+                   for (auto v : component) result.component[v] = result.count;
+                   result.count++;
+               });
+
+        return result;
+    }
+
+    Components strongly_connected_components(const SubgraphView& view) {
+        Components result;
+        result.component.assign(view.size(), none);
+
+        // tarjan's scratch is sized by the members, so ids go through their slot
+        std::vector<std::size_t> members, slot(view.size(), none);
+        for (std::size_t v = 0; v < view.size(); v++) {
+            if (!view.contains(v)) continue;
+            slot[v] = members.size();
+            members.push_back(v);
+        }
+
+        tarjan(view, members,
+               [&view](std::size_t v) { return view.contains(v); },
+               [&slot](std::size_t v) { return slot[v]; },
+               [&result](const std::vector<std::size_t>& component) {
+                   for (auto v : component) result.component[v] = result.count;
+                   result.count++;
+               });
+
+        return result;
+    }
+
+    Components strongly_connected_components_parallel(const Snapshot& snapshot) {
+        constexpr std::size_t small_set = 4096;
+        constexpr int trim_rounds = 4;
+
+        auto n = snapshot.size();
+
+        std::vector<std::size_t> reverse_offsets, reverse_targets;
+        snapshot.transpose(reverse_offsets, reverse_targets);
+
+        // Every vertex carries the colour of the piece it still belongs to; finished
+        // vertices are coloured `none`.
+        std::vector<std::atomic<std::size_t>> color(n);
+        for (auto& c : color) c.store(0, std::memory_order_relaxed);
+        std::atomic<std::size_t> colors{1};
+
+        Components result;
+        result.component.assign(n, none);
+        std::atomic<std::size_t> count{0};
+
+        // Vertices without live predecessors or successors are singleton components.
+        auto live = [&color](const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& targets, std::size_t v) {
+            for (auto e = offsets[v]; e < offsets[v + 1]; e++) {
+                if (targets[e] != v && color[targets[e]].load() != none) return true;
+            }
+            return false;
+        };
+
+        for (int round = 0; round < trim_rounds; round++) {
+            std::atomic<bool> trimmed{false};
+
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto v = lo; v < hi; v++) {
+                    if (color[v].load() == none) continue;
+                    if (live(snapshot.offsets, snapshot.targets, v) && live(reverse_offsets, reverse_targets, v)) continue;
+
+                    result.component[v] = count++;
+                    color[v].store(none);
+                    trimmed = true;
+                }
+            });
+
+            if (!trimmed) break;
+        }
+
+        std::vector<std::pair<std::size_t, std::vector<std::size_t>>> work;
+        std::vector<std::pair<std::size_t, std::vector<std::size_t>>> small;
+        {
+            std::vector<std::size_t> rest;
+            for (std::size_t v = 0; v < n; v++) {
+                if (color[v].load() != none) rest.push_back(v);
+            }
+            if (!rest.empty()) work.emplace_back(0, std::move(rest));
+        }
+
+        while (!work.empty()) {
+            auto [c, members] = std::move(work.back());
+            work.pop_back();
+
+            if (members.size() <= small_set) {
+                small.emplace_back(c, std::move(members));
+                continue;
+            }
+
+            auto forward = colors++;
+            auto backward = colors++;
+            auto scc = colors++;
+            auto pivot = members.front();
+
+            color[pivot].store(forward);
+            sweep(snapshot.offsets, snapshot.targets, {pivot}, [&](std::size_t w) {
+                auto expected = c;
+                return color[w].compare_exchange_strong(expected, forward);
+            });
+
+            color[pivot].store(scc);
+            sweep(reverse_offsets, reverse_targets, {pivot}, [&](std::size_t w) {
+                auto current = color[w].load();
+                if (current == forward) return color[w].compare_exchange_strong(current, scc);
+                if (current == c) return color[w].compare_exchange_strong(current, backward);
+                return false;
+            });
+
+            auto component = count++;
+            std::vector<std::size_t> forward_only, backward_only, rest;
+            for (auto v : members) {
+                auto current = color[v].load();
+                if (current == scc) {
+                    result.component[v] = component;
+                    color[v].store(none);
+                } else if (current == forward) {
+                    forward_only.push_back(v);
+                } else if (current == backward) {
+                    backward_only.push_back(v);
+                } else {
+                    rest.push_back(v);
+                }
+            }
+
+            if (!forward_only.empty()) work.emplace_back(forward, std::move(forward_only));
+            if (!backward_only.empty()) work.emplace_back(backward, std::move(backward_only));
+            if (!rest.empty()) work.emplace_back(c, std::move(rest));
+        }
+
+        // Each vertex is in exactly one leftover piece, so `slot` can be shared.
+        std::vector<std::size_t> slot(n);
+        parallel_for(0, small.size(), [&](std::size_t lo, std::size_t hi) {
+            for (auto i = lo; i < hi; i++) {
+                auto c = small[i].first;
+                const auto& members = small[i].second;
+                for (std::size_t j = 0; j < members.size(); j++) slot[members[j]] = j;
+
+                tarjan(snapshot, members,
+                       [&color, c](std::size_t w) { return color[w].load() == c; },
+                       [&slot](std::size_t w) { return slot[w]; },
+                       [&](const std::vector<std::size_t>& component) {
+                           auto id = count++;
+                           for (auto v : component) result.component[v] = id;
+                       });
+            }
+        }, 1);
+
+        result.count = count;
+        return result;
+    }
+
+    std::vector<std::vector<std::string>> strongly_connected_components(Graph& graph, bool parallel) {
+        Snapshot snapshot(graph);
+        auto components = parallel ? strongly_connected_components_parallel(snapshot) : strongly_connected_components(snapshot);
+
+        std::vector<std::vector<std::string>> res(components.count);
+        for (std::size_t v = 0; v < snapshot.size(); v++) {
+            res[components.component[v]].push_back(snapshot.names[v]);
+        }
+
+        return res;
+    }
+
+    std::unique_ptr<Graph> condensation(Graph& graph, const std::vector<std::vector<std::string>>& components) {
+        auto type = typestore_add("component");
+        auto res = std::make_unique<Graph>();
+
+        std::map<std::string, std::size_t> component_of;
+        for (std::size_t i = 0; i < components.size(); i++) {
+            auto v = res->add(std::to_string(i), type);
+            v->add_prop("members", components[i]);
+
+            for (const auto& name : components[i]) {
+                component_of[name] = i;
+            }
+        }
+
+        std::map<std::pair<std::size_t, std::size_t>, int> counts;
+        for (const auto& [name, vertex] : graph.vertices) {
+            auto from = component_of.find(name);
+            if (from == component_of.end()) continue;
+
+            for (const auto& edge : vertex->connections) {
+                if (!edge->live()) continue;
+
+                auto to = component_of.find(edge->to->name);
+                if (to == component_of.end() || to->second == from->second) continue;
+
+                counts[{from->second, to->second}]++;
+            }
+        }
+
+        for (const auto& [link, count] : counts) {
+            auto props = res->link(std::to_string(link.first), std::to_string(link.second), false);
+            (*props)["count"] = count;
+        }
+
+        return res;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef TINYGRAPH_COMPONENTS_H
+#define TINYGRAPH_COMPONENTS_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Graph;
+    class Snapshot;
+    class SubgraphView;
+
+    // component[v] is the strongly connected component of snapshot vertex v, numbered
+    // 0..count-1.
+    struct Components {
+        std::vector<std::size_t> component;
+        std::size_t count = 0;
+    };
+
+    // Iterative Tarjan. Components are numbered in reverse topological order of the
+    // condensation, i.e. a component only has edges into components with smaller ids.
+    Components strongly_connected_components(const Snapshot& snapshot);
+
+    // Components of the view; vertices outside it get component SIZE_MAX and are not
+    // counted.
+    Components strongly_connected_components(const SubgraphView& view);
+
+    // Forward-backward decomposition with trimming; reachability sweeps run on the
+    // default thread pool and the small leftover pieces are finished with Tarjan in
+    // parallel. Component ids carry no ordering.
+    Components strongly_connected_components_parallel(const Snapshot& snapshot);
+
+    std::vector<std::vector<std::string>> strongly_connected_components(Graph& graph, bool parallel = false);
+
+    // Builds the DAG of the given components: vertex i stands for components[i] (and
+    // has a "members" property listing them), and there is a single directed edge
+    // between two components whenever the original graph has at least one, with a
+    // "count" property holding how many.
+    std::unique_ptr<Graph> condensation(Graph& graph, const std::vector<std::vector<std::string>>& components);
+}
+
+#endif //TINYGRAPH_COMPONENTS_H
@@ -14,12 +14,16 @@ namespace tinygraph {
 
         auto to_edge = std::make_shared<Edge>(to_cp);
         to_edge->properties = std::make_shared<std::map<std::string, std::any>>();
-        from_cp->connections.push_back(to_edge);
+        to_cp->in_edges++;
+        from_cp->connect(to_edge);
 
         if (undirected) {
             auto from_edge = std::make_shared<Edge>(from_cp);
             from_edge->properties = to_edge->properties;
-            to_edge->to->connections.push_back(from_edge);
+            from_edge->reverse = to_edge;
+            to_edge->reverse = from_edge;
+            from_cp->in_edges++;
+            to_edge->to->connect(from_edge);
         }
 
         return to_edge->properties;
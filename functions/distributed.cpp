@@ -0,0 +1,155 @@
+#include "distributed.h"
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+namespace tinygraph {
+    namespace {
+        constexpr std::uint8_t active = 1;
+        constexpr std::uint8_t failed = 2;
+
+        struct Visit {
+            std::size_t vertex;
+        };
+
+        // hops counts the edges on the path behind the label; a label can only get
+        // size() or more of them by going round a negative cycle
+        struct Label {
+            std::size_t vertex;
+            double distance;
+            std::size_t parent;
+            std::size_t hops;
+        };
+
+        // The updates for a ghost go to outgoing[owner], so every owner has to be a rank
+        // of this transport.
+        void check_owners(const Shard& shard, const Transport& transport) {
+            for (auto rank : shard.owner) {
+                if (rank >= transport.size()) throw std::invalid_argument("shard owner is not a rank of the transport");
+            }
+        }
+    }
+
+    std::vector<std::size_t> distributed_bfs(const Shard& shard, Transport& transport, std::size_t source) {
+        check_owners(shard, transport);
+
+        std::vector<std::size_t> level(shard.size(), unreachable);
+        std::vector<std::size_t> frontier, next;
+
+        auto start = shard.local.find(source);
+        if (start != shard.local.end() && !shard.is_ghost(start->second)) {
+            level[start->second] = 0;
+            frontier.push_back(start->second);
+        }
+
+        std::vector<std::vector<Visit>> outgoing(transport.size());
+        std::vector<Visit> incoming;
+
+        for (std::size_t depth = 1;; depth++) {
+            bool sent = false;
+            for (auto v : frontier) {
+                for (auto arc : shard.neighbours(v)) {
+                    if (level[arc.to] != unreachable) continue;
+
+                    level[arc.to] = depth;
+                    if (shard.is_ghost(arc.to)) {
+                        outgoing[shard.owner[arc.to]].push_back({shard.global[arc.to]});
+                        sent = true;
+                    } else {
+                        next.push_back(arc.to);
+                    }
+                }
+            }
+
+            auto flags = exchange_updates(transport, outgoing, incoming, sent || !next.empty() ? active : 0);
+            for (auto& updates : outgoing) updates.clear();
+            if (!(flags & active)) break;
+
+            for (auto& visit : incoming) {
+                auto v = shard.local.at(visit.vertex);
+                if (level[v] != unreachable) continue;
+
+                level[v] = depth;
+                next.push_back(v);
+            }
+
+            frontier.swap(next);
+            next.clear();
+        }
+
+        level.resize(shard.owned);
+        return level;
+    }
+
+    bool distributed_shortest_paths(const Shard& shard, Transport& transport, std::size_t source, ShortestPaths& paths) {
+        check_owners(shard, transport);
+
+        const auto infinity = std::numeric_limits<double>::infinity();
+
+        std::vector<double> distance(shard.size(), infinity);
+        std::vector<std::size_t> parent(shard.size(), unreachable);
+        std::vector<std::size_t> hops(shard.size(), 0);
+        std::vector<char> queued(shard.size(), false), dirty(shard.size(), false);
+        std::deque<std::size_t> queue;
+        std::vector<std::size_t> ghosts;
+        bool broken = false;
+
+        auto improve = [&](std::size_t v, double d, std::size_t from, std::size_t length) {
+            distance[v] = d;
+            parent[v] = from;
+            hops[v] = length;
+            if (length >= shard.global_size) broken = true;
+
+            if (shard.is_ghost(v)) {
+                if (!dirty[v]) ghosts.push_back(v);
+                dirty[v] = true;
+            } else if (!queued[v]) {
+                queued[v] = true;
+                queue.push_back(v);
+            }
+        };
+
+        auto start = shard.local.find(source);
+        if (start != shard.local.end() && !shard.is_ghost(start->second)) improve(start->second, 0, unreachable, 0);
+
+        std::vector<std::vector<Label>> outgoing(transport.size());
+        std::vector<Label> incoming;
+
+        for (std::size_t round = 0;; round++) {
+            while (!queue.empty() && !broken) {
+                auto v = queue.front();
+                queue.pop_front();
+                queued[v] = false;
+
+                for (auto arc : shard.neighbours(v)) {
+                    auto candidate = distance[v] + arc.weight;
+                    if (candidate < distance[arc.to]) improve(arc.to, candidate, shard.global[v], hops[v] + 1);
+                }
+            }
+
+            for (auto v : ghosts) {
+                outgoing[shard.owner[v]].push_back({shard.global[v], distance[v], parent[v], hops[v]});
+                dirty[v] = false;
+            }
+
+            std::uint8_t flags = ghosts.empty() ? 0 : active;
+            if (broken || round > shard.global_size) flags |= failed;
+            ghosts.clear();
+
+            flags = exchange_updates(transport, outgoing, incoming, flags);
+            for (auto& updates : outgoing) updates.clear();
+
+            if (flags & failed) return false;
+            if (!(flags & active)) break;
+
+            for (auto& label : incoming) {
+                auto v = shard.local.at(label.vertex);
+                if (label.distance < distance[v]) improve(v, label.distance, label.parent, label.hops);
+            }
+        }
+
+        paths.distance.assign(distance.begin(), distance.begin() + shard.owned);
+        paths.parent.assign(parent.begin(), parent.begin() + shard.owned);
+        return true;
+    }
+}
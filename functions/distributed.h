@@ -0,0 +1,26 @@
+#ifndef TINYGRAPH_DISTRIBUTED_H
+#define TINYGRAPH_DISTRIBUTED_H
+
+#include "traversal.h"
+#include "transport.h"
+#include <data/shard.h>
+#include <cstddef>
+#include <vector>
+
+namespace tinygraph {
+    // Bulk-synchronous algorithms over a partitioned snapshot: every rank calls them
+    // with its own shard and transport, works on the vertices it owns and sends the
+    // updates for ghost vertices to their owners between supersteps. Sources are
+    // snapshot ids, results are for the shard's owned vertices (local ids
+    // 0..owned-1) and match bfs/dijkstra on the whole snapshot. Both throw
+    // std::invalid_argument if the shard names an owner the transport has no rank for.
+
+    // Hop count from source, or `unreachable`.
+    std::vector<std::size_t> distributed_bfs(const Shard& shard, Transport& transport, std::size_t source);
+
+    // Label-correcting shortest paths; parents are snapshot ids. Negative weights are
+    // fine; if a negative cycle is reachable every rank returns false.
+    bool distributed_shortest_paths(const Shard& shard, Transport& transport, std::size_t source, ShortestPaths& paths);
+}
+
+#endif //TINYGRAPH_DISTRIBUTED_H
@@ -0,0 +1,226 @@
+#include "export.h"
+#include "util.h"
+#include <data/graph.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+
+namespace tinygraph {
+    namespace {
+        using Sink = std::function<void(const char*, std::size_t)>;
+        using Entry = std::map<std::string, std::shared_ptr<Vertex>>::value_type;
+
+        // vertices per parallel batch
+        constexpr std::size_t batch_vertices = 256;
+
+        void append_quoted(std::string& out, const std::string& value, bool json) {
+            out += '"';
+            for (unsigned char c : value) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else if (json && c < 0x20) {
+                    static constexpr char hex[] = "0123456789abcdef";
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 15];
+                } else {
+                    out += c;
+                }
+            }
+            out += '"';
+        }
+
+        void append_json(std::string& out, const std::any& value) {
+            double number;
+            if (value.type() == typeid(int)) {
+                out += std::to_string(std::any_cast<int>(value));
+            } else if (any_to_double(&value, number)) {
+                out += std::isfinite(number) ? double_to_str(number) : "null";
+            } else if (value.type() == typeid(std::string) || value.type() == typeid(const char*)) {
+                append_quoted(out, any_to_str(&value), true);
+            } else {
+                out += "null";
+            }
+        }
+
+        template<typename Properties>
+        void append_properties(std::string& out, const Properties& properties, ExportFormat format) {
+            bool first = true;
+            for (const auto& [key, value] : properties) {
+                switch (format) {
+                    case ExportFormat::text:
+                        out += " [" + key + " = " + any_to_str(&value) + "]";
+                        break;
+                    case ExportFormat::dot:
+                        out += first ? " [" : ", ";
+                        append_quoted(out, key, false);
+                        out += '=';
+                        append_quoted(out, any_to_str(&value), false);
+                        break;
+                    case ExportFormat::jsonl:
+                        if (!first) out += ',';
+                        append_quoted(out, key, true);
+                        out += ':';
+                        append_json(out, value);
+                        break;
+                    case ExportFormat::edge_list:
+                        break;
+                }
+                first = false;
+            }
+            if (format == ExportFormat::dot && !first) out += ']';
+        }
+
+        void append_vertex(std::string& out, const Entry& entry, const ExportOptions& options) {
+            const auto& [name, vertex] = entry;
+
+            switch (options.format) {
+                case ExportFormat::text:
+                    out += name;
+                    append_properties(out, vertex->properties, options.format);
+                    out += '\n';
+                    break;
+                case ExportFormat::dot:
+                    out += "  ";
+                    append_quoted(out, name, false);
+                    append_properties(out, vertex->properties, options.format);
+                    out += ";\n";
+                    break;
+                case ExportFormat::jsonl:
+                    out += "{\"vertex\":";
+                    append_quoted(out, name, true);
+                    out += ",\"type\":";
+                    if (vertex->type) append_quoted(out, vertex->type->name, true);
+                    else out += "null";
+                    out += ",\"properties\":{";
+                    append_properties(out, vertex->properties, options.format);
+                    out += "}}\n";
+                    break;
+                case ExportFormat::edge_list:
+                    break;
+            }
+
+            for (const auto& edge : vertex->connections) {
+                if (!edge->live()) continue;
+                const auto& to = edge->to->name;
+
+                switch (options.format) {
+                    case ExportFormat::text:
+                        out += "\t" + name + " -> " + to;
+                        append_properties(out, *edge->properties, options.format);
+                        out += '\n';
+                        break;
+                    case ExportFormat::dot:
+                        out += "  ";
+                        append_quoted(out, name, false);
+                        out += " -> ";
+                        append_quoted(out, to, false);
+                        append_properties(out, *edge->properties, options.format);
+                        out += ";\n";
+                        break;
+                    case ExportFormat::jsonl:
+                        out += "{\"from\":";
+                        append_quoted(out, name, true);
+                        out += ",\"to\":";
+                        append_quoted(out, to, true);
+                        out += ",\"properties\":{";
+                        append_properties(out, *edge->properties, options.format);
+                        out += "}}\n";
+                        break;
+                    case ExportFormat::edge_list: {
+                        out += name + ' ' + to;
+                        if (!options.weight_property.empty()) {
+                            auto it = edge->properties->find(options.weight_property);
+                            double weight;
+                            if (it == edge->properties->end() || !any_to_double(&it->second, weight)) {
+                                throw std::invalid_argument("edge " + name + " -> " + to + " has no numeric " + options.weight_property);
+                            }
+                            out += ' ' + double_to_str(weight);
+                        }
+                        out += '\n';
+                        break;
+                    }
+                }
+            }
+        }
+
+        void export_to(const Graph& graph, const Sink& sink, const ExportOptions& options, ThreadPool& pool) {
+            std::string buffer;
+            buffer.reserve(options.chunk_bytes + 1024);
+            auto flush = [&buffer, &sink]() {
+                if (!buffer.empty()) sink(buffer.data(), buffer.size());
+                buffer.clear();
+            };
+
+            if (options.format == ExportFormat::dot) buffer += "digraph {\n";
+
+            if (!options.parallel || pool.size() == 0) {
+                for (const auto& entry : graph.vertices) {
+                    append_vertex(buffer, entry, options);
+                    if (buffer.size() >= options.chunk_bytes) flush();
+                }
+            } else {
+                // A window of batches is serialized in parallel, then written in order.
+                auto batches = 4 * (pool.size() + 1);
+                std::vector<const Entry*> window;
+                std::vector<std::string> parts(batches);
+                window.reserve(batches * batch_vertices);
+
+                for (auto it = graph.vertices.begin(); it != graph.vertices.end();) {
+                    window.clear();
+                    for (; it != graph.vertices.end() && window.size() < batches * batch_vertices; ++it) window.push_back(&*it);
+
+                    auto used = (window.size() + batch_vertices - 1) / batch_vertices;
+                    parallel_for(0, used, [&](std::size_t lo, std::size_t hi) {
+                        for (auto b = lo; b < hi; b++) {
+                            parts[b].clear();
+                            auto last = std::min(window.size(), (b + 1) * batch_vertices);
+                            for (auto v = b * batch_vertices; v < last; v++) append_vertex(parts[b], *window[v], options);
+                        }
+                    }, 1, pool);
+
+                    for (std::size_t b = 0; b < used; b++) {
+                        if (parts[b].size() >= options.chunk_bytes) {
+                            flush();
+                            sink(parts[b].data(), parts[b].size());
+                        } else {
+                            buffer += parts[b];
+                            if (buffer.size() >= options.chunk_bytes) flush();
+                        }
+                    }
+                }
+            }
+
+            if (options.format == ExportFormat::dot) buffer += "}\n";
+            flush();
+        }
+    }
+
+    void export_graph(const Graph& graph, std::ostream& out, const ExportOptions& options, ThreadPool& pool) {
+        export_to(graph, [&out](const char* data, std::size_t size) {
+            if (!out.write(data, size)) throw std::runtime_error("export: stream write failed");
+        }, options, pool);
+    }
+
+    void export_graph(const Graph& graph, int fd, const ExportOptions& options, ThreadPool& pool) {
+        export_to(graph, [fd](const char* data, std::size_t size) {
+            while (size > 0) {
+                auto written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error(std::string("export: ") + std::strerror(errno));
+                }
+                data += written;
+                size -= written;
+            }
+        }, options, pool);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef TINYGRAPH_EXPORT_H
+#define TINYGRAPH_EXPORT_H
+
+#include "parallel.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace tinygraph {
+    class Graph;
+
+    // text is the format of Graph::str(). dot writes a digraph with properties as
+    // attributes, jsonl one JSON object per vertex followed by one per outgoing edge,
+    // and edge_list one "from to" line per edge. Undirected links appear once per
+    // direction in every format.
+    enum class ExportFormat { text, dot, jsonl, edge_list };
+
+    struct ExportOptions {
+        ExportFormat format = ExportFormat::text;
+
+        // edge_list only: adds this numeric edge property as a third column; an edge
+        // without it makes the export throw std::invalid_argument.
+        std::string weight_property;
+
+        // Output is collected into chunks of about this size before it is written.
+        std::size_t chunk_bytes = 1 << 16;
+
+        // Serializes batches of vertices on the pool; the output is the same as
+        // without it.
+        bool parallel = false;
+    };
+
+    // Streams the graph in vertex name order. Only a bounded window of vertices is
+    // serialized ahead of the writer, so the extra memory does not grow with the
+    // graph. Throws std::runtime_error if the stream or descriptor fails.
+    void export_graph(const Graph& graph, std::ostream& out, const ExportOptions& options = {}, ThreadPool& pool = default_pool());
+
+    void export_graph(const Graph& graph, int fd, const ExportOptions& options = {}, ThreadPool& pool = default_pool());
+}
+
+#endif //TINYGRAPH_EXPORT_H
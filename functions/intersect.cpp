@@ -0,0 +1,105 @@
+#include "intersect.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TINYGRAPH_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace tinygraph {
+    std::size_t intersect_count_scalar(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size) {
+        std::size_t count = 0;
+        std::size_t i = 0;
+        std::size_t j = 0;
+
+        while (i < a_size && j < b_size) {
+            if (a[i] < b[j]) {
+                i++;
+            } else if (b[j] < a[i]) {
+                j++;
+            } else {
+                count++;
+                i++;
+                j++;
+            }
+        }
+
+        return count;
+    }
+
+#ifdef TINYGRAPH_X86_SIMD
+    namespace {
+        // Compares a block of a against every rotation of a block of b, then advances
+        // whichever block ends first (both when their last values are equal). Since the
+        // inputs hold no duplicates, every lane matches at most once.
+        std::size_t intersect_count_sse2(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size) {
+            std::size_t count = 0;
+            std::size_t i = 0;
+            std::size_t j = 0;
+
+            while (i + 4 <= a_size && j + 4 <= b_size) {
+                auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+                auto m = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                        _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+                count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(m)));
+
+                auto a_last = a[i + 3];
+                auto b_last = b[j + 3];
+                if (a_last <= b_last) i += 4;
+                if (b_last <= a_last) j += 4;
+            }
+
+            return count + intersect_count_scalar(a + i, a_size - i, b + j, b_size - j);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t intersect_count_avx2(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size) {
+            std::size_t count = 0;
+            std::size_t i = 0;
+            std::size_t j = 0;
+
+            const auto rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+            while (i + 8 <= a_size && j + 8 <= b_size) {
+                auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+
+                auto m = _mm256_cmpeq_epi32(va, vb);
+                for (int r = 1; r < 8; r++) {
+                    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                    m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+                }
+
+                count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+
+                auto a_last = a[i + 7];
+                auto b_last = b[j + 7];
+                if (a_last <= b_last) i += 8;
+                if (b_last <= a_last) j += 8;
+            }
+
+            return count + intersect_count_sse2(a + i, a_size - i, b + j, b_size - j);
+        }
+
+        using intersect_fn = std::size_t (*)(const std::uint32_t*, std::size_t, const std::uint32_t*, std::size_t);
+
+        intersect_fn pick() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return intersect_count_avx2;
+            return intersect_count_sse2;
+        }
+    }
+
+    std::size_t intersect_count(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size) {
+        static const intersect_fn impl = pick();
+        return impl(a, a_size, b, b_size);
+    }
+#else
+    std::size_t intersect_count(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size) {
+        return intersect_count_scalar(a, a_size, b, b_size);
+    }
+#endif
+}
@@ -0,0 +1,15 @@
+#ifndef TINYGRAPH_INTERSECT_H
+#define TINYGRAPH_INTERSECT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tinygraph {
+    // Number of values common to two strictly increasing arrays. Uses an AVX2 or SSE2
+    // block merge when the CPU has it and a plain merge otherwise.
+    std::size_t intersect_count(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size);
+
+    std::size_t intersect_count_scalar(const std::uint32_t* a, std::size_t a_size, const std::uint32_t* b, std::size_t b_size);
+}
+
+#endif //TINYGRAPH_INTERSECT_H
@@ -0,0 +1,265 @@
+#include "k_shortest.h"
+#include "traversal.h"
+#include <data/snapshot.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace tinygraph {
+    namespace {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+
+        struct Candidate {
+            double length;
+            std::vector<std::size_t> vertices;
+            // index of the spur node, where the path leaves the one it was derived from
+            std::size_t deviation;
+
+            bool operator<(const Candidate& other) const {
+                if (length != other.length) return length < other.length;
+                return vertices < other.vertices;
+            }
+        };
+
+        // Lightest arc from one vertex to another, so that parallel edges do not matter.
+        double arc_weight(const Snapshot& snapshot, std::size_t from, std::size_t to) {
+            double res = infinity;
+            for (auto arc : snapshot.neighbours(from)) {
+                if (arc.to == to) res = std::min(res, arc.weight);
+            }
+            return res;
+        }
+
+        // Distance from every vertex to the target and the next vertex on a shortest
+        // path there, by Dijkstra over the reversed arcs.
+        void reverse_tree(const Snapshot& snapshot, std::size_t target, std::vector<double>& distance, std::vector<std::size_t>& next) {
+            auto n = snapshot.size();
+            std::vector<std::size_t> offsets(n + 1, 0), sources(snapshot.targets.size());
+            std::vector<double> weights(snapshot.targets.size());
+            for (auto to : snapshot.targets) offsets[to + 1]++;
+            for (std::size_t v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+
+            auto fill = offsets;
+            for (std::size_t v = 0; v < n; v++) {
+                for (auto arc : snapshot.neighbours(v)) {
+                    sources[fill[arc.to]] = v;
+                    weights[fill[arc.to]++] = arc.weight;
+                }
+            }
+
+            using entry = std::pair<double, std::size_t>;
+            std::priority_queue<entry, std::vector<entry>, std::greater<>> queue;
+            distance.assign(n, infinity);
+            next.assign(n, unreachable);
+            distance[target] = 0;
+            queue.emplace(0.0, target);
+
+            while (!queue.empty()) {
+                auto [d, v] = queue.top();
+                queue.pop();
+                if (d > distance[v]) continue;
+
+                for (auto e = offsets[v]; e < offsets[v + 1]; e++) {
+                    auto candidate = d + weights[e];
+                    if (candidate < distance[sources[e]]) {
+                        distance[sources[e]] = candidate;
+                        next[sources[e]] = v;
+                        queue.emplace(candidate, sources[e]);
+                    }
+                }
+            }
+        }
+
+        // Per-thread scratch of the spur searches, stamped so that it needs no
+        // clearing between searches.
+        struct Scratch {
+            std::vector<std::uint32_t> blocked, settled, reached;
+            std::vector<double> cost;
+            std::vector<std::size_t> parent;
+            std::uint32_t stamp = 0;
+
+            void prepare(std::size_t n) {
+                if (blocked.size() != n || ++stamp == 0) {
+                    blocked.assign(n, 0);
+                    settled.assign(n, 0);
+                    reached.assign(n, 0);
+                    cost.assign(n, infinity);
+                    parent.assign(n, unreachable);
+                    stamp = 1;
+                }
+            }
+        };
+
+        class Spur {
+        public:
+            Spur(const Snapshot& snapshot, std::size_t target, const std::vector<double>& to_target, const std::vector<std::size_t>& next)
+                    : snapshot(snapshot), target(target), to_target(to_target), next(next) { }
+
+            // Shortest path from path[spur] to the target that avoids path[0..spur-1] and
+            // the arcs from path[spur] to `removed`; empty if there is none.
+            std::vector<std::size_t> search(const std::vector<std::size_t>& path, std::size_t spur, const std::vector<std::size_t>& removed) const {
+                thread_local Scratch scratch;
+                scratch.prepare(snapshot.size());
+                auto stamp = scratch.stamp;
+                for (std::size_t i = 0; i < spur; i++) scratch.blocked[path[i]] = stamp;
+
+                auto start = path[spur];
+                auto allowed = [&](std::size_t from, std::size_t to) {
+                    if (scratch.blocked[to] == stamp || to_target[to] == infinity) return false;
+                    return from != start || std::find(removed.begin(), removed.end(), to) == removed.end();
+                };
+
+                std::vector<std::size_t> res;
+                if (to_target[start] == infinity) return res;
+
+                // the tree path is as short as anything can be, so take it when it is free
+                bool free = true;
+                for (auto v = start; v != target && free; v = next[v]) free = allowed(v, next[v]);
+                if (free) {
+                    for (auto v = start; v != unreachable; v = next[v]) {
+                        res.push_back(v);
+                        if (v == target) break;
+                    }
+                    return res;
+                }
+
+                // A* on reduced costs w(u, v) + h(v) - h(u), which stay non-negative
+                using entry = std::pair<double, std::size_t>;
+                std::priority_queue<entry, std::vector<entry>, std::greater<>> queue;
+                auto reach = [&](std::size_t v, double cost, std::size_t parent) {
+                    scratch.reached[v] = stamp;
+                    scratch.cost[v] = cost;
+                    scratch.parent[v] = parent;
+                    queue.emplace(cost + to_target[v], v);
+                };
+                reach(start, 0, unreachable);
+
+                while (!queue.empty()) {
+                    auto v = queue.top().second;
+                    queue.pop();
+                    if (scratch.settled[v] == stamp) continue;
+                    scratch.settled[v] = stamp;
+
+                    if (v == target) {
+                        for (auto u = target; u != unreachable; u = scratch.parent[u]) res.push_back(u);
+                        std::reverse(res.begin(), res.end());
+                        return res;
+                    }
+
+                    for (auto arc : snapshot.neighbours(v)) {
+                        if (scratch.settled[arc.to] == stamp || !allowed(v, arc.to)) continue;
+
+                        auto cost = scratch.cost[v] + arc.weight;
+                        if (scratch.reached[arc.to] != stamp || cost < scratch.cost[arc.to]) reach(arc.to, cost, v);
+                    }
+                }
+                return res;
+            }
+
+        private:
+            const Snapshot& snapshot;
+            std::size_t target;
+            const std::vector<double>& to_target;
+            const std::vector<std::size_t>& next;
+        };
+    }
+
+    std::vector<WeightedPath> k_shortest_paths(const Snapshot& snapshot, std::size_t source, std::size_t target, std::size_t k,
+                                               ThreadPool& pool, const CancellationToken& token) {
+        for (auto weight : snapshot.weights) {
+            if (weight < 0) throw std::invalid_argument("k_shortest_paths needs non-negative weights");
+        }
+
+        std::vector<WeightedPath> res;
+        if (k == 0) return res;
+        if (source == target) {
+            res.push_back({0, {source}});
+            return res;
+        }
+
+        std::vector<double> to_target;
+        std::vector<std::size_t> next;
+        reverse_tree(snapshot, target, to_target, next);
+        if (to_target[source] == infinity) return res;
+
+        auto length_of = [&snapshot](const std::vector<std::size_t>& vertices) {
+            double length = 0;
+            for (std::size_t i = 0; i + 1 < vertices.size(); i++) length += arc_weight(snapshot, vertices[i], vertices[i + 1]);
+            return length;
+        };
+
+        Spur spur(snapshot, target, to_target, next);
+        std::vector<std::size_t> deviations;
+        std::set<Candidate> candidates;
+        std::set<std::vector<std::size_t>> known;
+
+        auto first = spur.search({source}, 0, {});
+        known.insert(first);
+        res.push_back({length_of(first), std::move(first)});
+        deviations.push_back(0);
+
+        while (res.size() < k) {
+            token.check();
+            const auto& last = res.back().vertices;
+
+            // spur nodes before the deviation were searched for the path this one came from
+            auto from = deviations.back();
+            auto spurs = last.size() - 1 - std::min(from, last.size() - 1);
+            std::vector<std::vector<std::size_t>> found(spurs);
+
+            parallel_for(0, spurs, [&](std::size_t lo, std::size_t hi) {
+                std::vector<std::size_t> removed;
+                for (auto s = lo; s < hi; s++) {
+                    auto i = from + s;
+
+                    // every accepted path sharing this root leaves it along an arc that
+                    // must not be taken again
+                    removed.clear();
+                    for (const auto& path : res) {
+                        if (path.vertices.size() > i + 1 && std::equal(last.begin(), last.begin() + i + 1, path.vertices.begin())) {
+                            removed.push_back(path.vertices[i + 1]);
+                        }
+                    }
+
+                    auto tail = spur.search(last, i, removed);
+                    if (tail.empty()) continue;
+                    found[s].assign(last.begin(), last.begin() + i);
+                    found[s].insert(found[s].end(), tail.begin(), tail.end());
+                }
+            }, 1, pool);
+
+            for (std::size_t s = 0; s < spurs; s++) {
+                if (found[s].empty() || !known.insert(found[s]).second) continue;
+                auto length = length_of(found[s]);
+                candidates.insert({length, std::move(found[s]), from + s});
+            }
+
+            if (candidates.empty()) break;
+            auto best = candidates.begin();
+            res.push_back({best->length, best->vertices});
+            deviations.push_back(best->deviation);
+            candidates.erase(best);
+        }
+
+        return res;
+    }
+
+    std::vector<NamedPath> k_shortest_paths(Graph& graph, const std::string& source, const std::string& target, const std::string& weight_property, std::size_t k,
+                                            const CancellationToken& token) {
+        Snapshot snapshot(graph, weight_property);
+        if (!snapshot.ids.count(source)) throw std::invalid_argument("unknown vertex " + source);
+        if (!snapshot.ids.count(target)) throw std::invalid_argument("unknown vertex " + target);
+
+        std::vector<NamedPath> res;
+        for (auto& path : k_shortest_paths(snapshot, snapshot.id(source), snapshot.id(target), k, default_pool(), token)) {
+            NamedPath named{path.length, {}};
+            for (auto v : path.vertices) named.vertices.push_back(snapshot.names[v]);
+            res.push_back(std::move(named));
+        }
+        return res;
+    }
+}
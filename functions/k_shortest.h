@@ -0,0 +1,46 @@
+#ifndef TINYGRAPH_K_SHORTEST_H
+#define TINYGRAPH_K_SHORTEST_H
+
+#include "cancellation.h"
+#include "parallel.h"
+#include <data/graph.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Snapshot;
+
+    struct WeightedPath {
+        double length = 0;
+        std::vector<std::size_t> vertices;
+    };
+
+    struct NamedPath {
+        double length = 0;
+        std::vector<std::string> vertices;
+    };
+
+    // Up to k loopless paths from source to target in order of length (ties broken by
+    // vertex sequence), using Yen's algorithm. Weights must be non-negative; over a
+    // snapshot without weights the length is the hop count.
+    //
+    // One reverse Dijkstra from the target gives every vertex its exact distance to
+    // the target and a successor on a shortest path there. A spur search first tries
+    // that successor chain, which is optimal whenever it avoids the root path and the
+    // removed edges, and otherwise runs A* with the distances as heuristic. Only spur
+    // nodes at or after the point where a path left its parent are searched (Lawler),
+    // since earlier ones would repeat the parent's searches, and the spur searches of
+    // one path run in parallel on the pool. The token is checked once per accepted
+    // path.
+    std::vector<WeightedPath> k_shortest_paths(const Snapshot& snapshot, std::size_t source, std::size_t target, std::size_t k,
+                                               ThreadPool& pool = default_pool(), const CancellationToken& token = CancellationToken::never());
+
+    // Same over a graph's weight_property. Throws std::invalid_argument for unknown
+    // vertices, missing or non-numeric weights and negative weights.
+    std::vector<NamedPath> k_shortest_paths(Graph& graph, const std::string& source, const std::string& target, const std::string& weight_property, std::size_t k,
+                                            const CancellationToken& token = CancellationToken::never());
+}
+
+#endif //TINYGRAPH_K_SHORTEST_H
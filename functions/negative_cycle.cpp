@@ -0,0 +1,169 @@
+#include "negative_cycle.h"
+#include <data/graph.h>
+#include <data/snapshot.h>
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace tinygraph {
+    namespace {
+        // Shortest-path tree kept as a circular preorder list through a virtual root,
+        // with depths, so that a subtree is a vertex and the run of deeper vertices
+        // after it.
+        class Tree {
+        public:
+            explicit Tree(std::size_t n) : root(n), next(n + 1, n), previous(n + 1, n), depth(n + 1, 0), member(n + 1, false) {
+                member[root] = true;
+            }
+
+            bool contains(std::size_t v) const { return member[v]; }
+
+            // Attaches v, which must not be in the tree, as a child of parent.
+            void attach(std::size_t v, std::size_t parent) {
+                next[v] = next[parent];
+                previous[next[parent]] = v;
+                next[parent] = v;
+                previous[v] = parent;
+                depth[v] = depth[parent] + 1;
+                member[v] = true;
+            }
+
+            // Takes v and its subtree out of the tree; returns true if `watch` was in it.
+            bool detach(std::size_t v, std::size_t watch) {
+                bool found = v == watch;
+                auto last = v;
+                member[v] = false;
+                for (auto x = next[v]; depth[x] > depth[v]; x = next[x]) {
+                    found = found || x == watch;
+                    member[x] = false;
+                    last = x;
+                }
+
+                next[previous[v]] = next[last];
+                previous[next[last]] = previous[v];
+                return found;
+            }
+
+            const std::size_t root;
+
+        private:
+            std::vector<std::size_t> next, previous, depth;
+            std::vector<char> member;
+        };
+    }
+
+    bool find_negative_cycle(const Snapshot& snapshot, std::size_t source, ShortestPaths& paths, NegativeCycle& cycle, bool settle, const CancellationToken& token) {
+        const auto infinity = std::numeric_limits<double>::infinity();
+        auto n = snapshot.size();
+
+        paths.distance.assign(n, infinity);
+        paths.parent.assign(n, unreachable);
+        cycle = {};
+
+        Tree tree(n);
+        std::vector<double> parent_weight(n, 0);
+        std::vector<char> queued(n, false), lost(n, false);
+        std::deque<std::size_t> queue;
+
+        auto start = [&](std::size_t v) {
+            paths.distance[v] = 0;
+            tree.attach(v, tree.root);
+            queued[v] = true;
+            queue.push_back(v);
+        };
+        if (source == unreachable) {
+            for (std::size_t v = n; v-- > 0;) start(v);
+        } else {
+            start(source);
+        }
+
+        // Everything reachable from a negative cycle has no shortest distance; it
+        // leaves the tree for good, and its -infinity never relaxes anything.
+        auto lose = [&](const std::vector<std::size_t>& from) {
+            std::vector<std::size_t> stack;
+            for (auto v : from) {
+                if (lost[v]) continue;
+                lost[v] = true;
+                stack.push_back(v);
+            }
+            while (!stack.empty()) {
+                auto v = stack.back();
+                stack.pop_back();
+                if (tree.contains(v)) tree.detach(v, unreachable);
+                paths.distance[v] = -infinity;
+                paths.parent[v] = unreachable;
+
+                for (auto arc : snapshot.neighbours(v)) {
+                    if (lost[arc.to]) continue;
+                    lost[arc.to] = true;
+                    stack.push_back(arc.to);
+                }
+            }
+        };
+
+        bool found = false;
+        for (std::size_t popped = 0; !queue.empty();) {
+            auto u = queue.front();
+            queue.pop_front();
+            queued[u] = false;
+            if (++popped % 1024 == 0) token.check();
+
+            // detached vertices wait until a shorter distance reaches them again
+            if (!tree.contains(u)) continue;
+
+            for (auto arc : snapshot.neighbours(u)) {
+                auto v = arc.to;
+                auto candidate = paths.distance[u] + arc.weight;
+                if (!(candidate < paths.distance[v])) continue;
+
+                // v's subtree is stale now; u inside it means v -> ... -> u -> v is negative
+                bool closes = v == u || (tree.contains(v) && tree.detach(v, u));
+                if (closes) {
+                    std::vector<std::size_t> members;
+                    double weight = arc.weight;
+                    for (auto x = u; x != v; x = paths.parent[x]) {
+                        members.push_back(x);
+                        weight += parent_weight[x];
+                    }
+                    members.push_back(v);
+                    std::reverse(members.begin(), members.end());
+
+                    if (!found) {
+                        cycle.vertices = members;
+                        cycle.weight = weight;
+                        found = true;
+                    }
+                    if (!settle) return true;
+
+                    lose(members);
+                    break;
+                }
+
+                paths.distance[v] = candidate;
+                paths.parent[v] = u;
+                parent_weight[v] = arc.weight;
+                tree.attach(v, u);
+                if (!queued[v]) {
+                    queued[v] = true;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        return found;
+    }
+
+    bool find_negative_cycle(Graph& graph, const std::string& weight_property, std::vector<std::string>& cycle, double& weight, const CancellationToken& token) {
+        Snapshot snapshot(graph, weight_property);
+
+        ShortestPaths paths;
+        NegativeCycle found;
+        bool negative = find_negative_cycle(snapshot, unreachable, paths, found, false, token);
+        graph.negative_cycle = negative ? Graph::negative : Graph::non_negative;
+
+        cycle.clear();
+        for (auto v : found.vertices) cycle.push_back(snapshot.names[v]);
+        weight = found.weight;
+        return negative;
+    }
+}
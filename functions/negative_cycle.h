@@ -0,0 +1,44 @@
+#ifndef TINYGRAPH_NEGATIVE_CYCLE_H
+#define TINYGRAPH_NEGATIVE_CYCLE_H
+
+#include "cancellation.h"
+#include "traversal.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Graph;
+    class Snapshot;
+
+    // vertices[0] -> vertices[1] -> ... -> vertices.back() -> vertices[0]; weight is
+    // the sum of the arcs the search went along.
+    struct NegativeCycle {
+        double weight = 0;
+        std::vector<std::size_t> vertices;
+    };
+
+    // Label-correcting shortest paths with Tarjan's subtree disassembly: whenever a
+    // vertex's distance drops, the subtree hanging off it in the shortest-path tree is
+    // taken out of the tree and the queue, as its labels are stale. Finding the
+    // relaxing vertex inside that subtree means the new arc closes a negative cycle,
+    // so the search stops at the first cycle instead of after a further full pass.
+    //
+    // With source `unreachable` every vertex starts at distance 0, which finds a
+    // negative cycle anywhere in the graph. Returns true and fills `cycle` if one was
+    // found. With settle set the search then goes on around it: vertices reachable
+    // from a negative cycle get distance -infinity and no parent, and every other
+    // vertex ends with its shortest distance and parent. Without settle, `paths` holds
+    // the upper bounds reached when the cycle showed up.
+    bool find_negative_cycle(const Snapshot& snapshot, std::size_t source, ShortestPaths& paths, NegativeCycle& cycle, bool settle = true,
+                             const CancellationToken& token = CancellationToken::never());
+
+    // Any negative cycle of the graph over weight_property, as vertex names. Sets
+    // graph.negative_cycle. Throws std::invalid_argument if some edge has no int,
+    // float or double weight_property.
+    bool find_negative_cycle(Graph& graph, const std::string& weight_property, std::vector<std::string>& cycle, double& weight,
+                             const CancellationToken& token = CancellationToken::never());
+}
+
+#endif //TINYGRAPH_NEGATIVE_CYCLE_H
@@ -0,0 +1,50 @@
+#include "parallel.h"
+
+namespace tinygraph {
+    ThreadPool::ThreadPool(std::size_t threads) {
+        for (std::size_t i = 0; i < threads; i++) {
+            workers.emplace_back([this]() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+                        if (stopping && queue.empty()) return;
+                        task = std::move(queue.front());
+                        queue.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(task));
+        }
+        ready.notify_one();
+    }
+
+    std::size_t ThreadPool::size() const {
+        return workers.size();
+    }
+
+    ThreadPool& default_pool() {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        return pool;
+    }
+}
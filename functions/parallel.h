@@ -0,0 +1,122 @@
+#ifndef TINYGRAPH_PARALLEL_H
+#define TINYGRAPH_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tinygraph {
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void post(std::function<void()> task);
+
+        template<typename F>
+        std::future<std::invoke_result_t<F>> submit(F&& f) {
+            auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+            auto future = task->get_future();
+            post([task]() { (*task)(); });
+            return future;
+        }
+
+        std::size_t size() const;
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> queue;
+        std::mutex mutex;
+        std::condition_variable ready;
+        bool stopping = false;
+    };
+
+    // Process-wide pool shared by the parallel algorithms. Callers of parallel_for
+    // take part in the work themselves, so nesting parallel_for inside a pool task
+    // cannot deadlock.
+    ThreadPool& default_pool();
+
+    namespace detail {
+        struct ParallelForState {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            std::size_t grain = 1;
+            std::size_t chunks = 0;
+            std::atomic<std::size_t> next{0};
+            std::size_t remaining = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::exception_ptr error;
+            std::function<void(std::size_t, std::size_t)> body;
+
+            void run() {
+                for (;;) {
+                    auto chunk = next.fetch_add(1);
+                    if (chunk >= chunks) return;
+
+                    auto lo = begin + chunk * grain;
+                    auto hi = std::min(end, lo + grain);
+
+                    try {
+                        body(lo, hi);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) error = std::current_exception();
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--remaining == 0) done.notify_all();
+                }
+            }
+        };
+    }
+
+    // Calls body(lo, hi) for consecutive sub-ranges of [begin, end) of at most grain
+    // elements, spread across the pool and the calling thread.
+    template<typename F>
+    void parallel_for(std::size_t begin, std::size_t end, F&& body, std::size_t grain = 1024, ThreadPool& pool = default_pool()) {
+        if (end <= begin) return;
+        grain = std::max<std::size_t>(grain, 1);
+
+        auto chunks = (end - begin + grain - 1) / grain;
+        if (chunks == 1 || pool.size() == 0) {
+            body(begin, end);
+            return;
+        }
+
+        auto state = std::make_shared<detail::ParallelForState>();
+        state->begin = begin;
+        state->end = end;
+        state->grain = grain;
+        state->chunks = chunks;
+        state->remaining = chunks;
+        state->body = [&body](std::size_t lo, std::size_t hi) { body(lo, hi); };
+
+        auto helpers = std::min(pool.size(), chunks - 1);
+        for (std::size_t i = 0; i < helpers; i++) {
+            pool.post([state]() { state->run(); });
+        }
+
+        state->run();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state]() { return state->remaining == 0; });
+
+        if (state->error) std::rethrow_exception(state->error);
+    }
+}
+
+#endif //TINYGRAPH_PARALLEL_H
@@ -0,0 +1,245 @@
+#ifndef TINYGRAPH_PREGEL_H
+#define TINYGRAPH_PREGEL_H
+
+#include "cancellation.h"
+#include "parallel.h"
+#include "traversal.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tinygraph {
+    // Bulk-synchronous vertex programs over any adjacency (Snapshot, SubgraphView,
+    // CompressedAdjacency, ...). In every superstep compute(context, messages) runs
+    // for each vertex that is active or has messages, with the messages sent to it in
+    // the previous superstep. A vertex that votes to halt sleeps until a message wakes
+    // it; the run ends when every vertex sleeps and no message is in flight.
+    //
+    // Vertices are split into contiguous partitions that run as tasks on the thread
+    // pool. Each partition buffers its outgoing messages per destination partition,
+    // and buffers are delivered in parallel between supersteps, so compute needs no
+    // locking as long as it only touches its own vertex's value.
+    template<typename Value, typename Message, typename Adjacency>
+    class Pregel {
+    public:
+        using Combiner = std::function<Message(const Message&, const Message&)>;
+        using Reducer = std::function<double(double, double)>;
+
+        class Context {
+        public:
+            std::size_t id() const { return vertex; }
+
+            std::size_t superstep() const { return engine->step; }
+
+            Value& value() { return engine->values[vertex]; }
+
+            auto neighbours() const { return engine->adjacency.neighbours(vertex); }
+
+            void send(std::size_t to, const Message& message) {
+                auto& outbox = engine->outboxes[partition][engine->partition_of(to)];
+                if (!engine->combiner) {
+                    outbox.messages.emplace_back(to, message);
+                    return;
+                }
+
+                auto it = outbox.combined.find(to);
+                if (it == outbox.combined.end()) outbox.combined.emplace(to, message);
+                else it->second = engine->combiner(it->second, message);
+            }
+
+            void vote_to_halt() { engine->active[vertex] = false; }
+
+            // Contributes to aggregator `index`; the total is visible through
+            // aggregated() in the next superstep.
+            void aggregate(std::size_t index, double value) {
+                auto& local = engine->partial[partition][index];
+                local = engine->aggregators[index].reduce(local, value);
+            }
+
+            double aggregated(std::size_t index) const { return engine->aggregators[index].value; }
+
+        private:
+            friend class Pregel;
+
+            Context(Pregel* engine, std::size_t partition, std::size_t vertex) : engine(engine), partition(partition), vertex(vertex) { }
+
+            Pregel* engine;
+            std::size_t partition;
+            std::size_t vertex;
+        };
+
+        // partitions = 0 picks a few per pool thread.
+        Pregel(const Adjacency& adjacency, Value initial, std::size_t partitions = 0, ThreadPool& pool = default_pool())
+                : values(adjacency.size(), initial), adjacency(adjacency), pool(pool) {
+            if (partitions == 0) partitions = 4 * (pool.size() + 1);
+            this->partitions = std::max<std::size_t>(1, std::min(partitions, adjacency.size()));
+            this->width = (adjacency.size() + this->partitions - 1) / this->partitions;
+            if (this->width == 0) this->width = 1;
+        }
+
+        // Merges the messages for one vertex as they are sent, so a vertex receives at
+        // most one message per superstep.
+        void combine_with(Combiner combine) { combiner = std::move(combine); }
+
+        // Registers a global reduction over the values passed to Context::aggregate
+        // during a superstep and returns its index.
+        std::size_t add_aggregator(double identity, Reducer reduce) {
+            aggregators.push_back({identity, identity, std::move(reduce)});
+            return aggregators.size() - 1;
+        }
+
+        double aggregated(std::size_t index) const { return aggregators[index].value; }
+
+        // Runs until the program halts or max_supersteps have run; returns the number
+        // of supersteps. Every vertex starts out active. The token is checked before
+        // every superstep.
+        template<typename Compute>
+        std::size_t run(Compute compute, std::size_t max_supersteps = std::numeric_limits<std::size_t>::max(), const CancellationToken& token = CancellationToken::never()) {
+            auto n = adjacency.size();
+            active.assign(n, true);
+            inbox.assign(n, {});
+            outboxes.assign(partitions, std::vector<Outbox>(partitions));
+            partial.assign(partitions, std::vector<double>(aggregators.size()));
+            std::vector<std::size_t> awake(partitions);
+
+            for (step = 0; step < max_supersteps; step++) {
+                token.check();
+
+                for (std::size_t p = 0; p < partitions; p++) {
+                    for (std::size_t i = 0; i < aggregators.size(); i++) partial[p][i] = aggregators[i].identity;
+                }
+
+                parallel_for(0, partitions, [&](std::size_t lo, std::size_t hi) {
+                    for (auto p = lo; p < hi; p++) {
+                        awake[p] = 0;
+                        for (auto v = first(p); v < last(p); v++) {
+                            if (!active[v] && inbox[v].empty()) continue;
+
+                            active[v] = true;
+                            Context context(this, p, v);
+                            compute(context, static_cast<const std::vector<Message>&>(inbox[v]));
+                            inbox[v].clear();
+                            awake[p] += active[v];
+                        }
+                    }
+                }, 1, pool);
+
+                for (std::size_t i = 0; i < aggregators.size(); i++) {
+                    auto total = aggregators[i].identity;
+                    for (std::size_t p = 0; p < partitions; p++) total = aggregators[i].reduce(total, partial[p][i]);
+                    aggregators[i].value = total;
+                }
+
+                std::vector<std::size_t> delivered(partitions);
+                parallel_for(0, partitions, [&](std::size_t lo, std::size_t hi) {
+                    for (auto target = lo; target < hi; target++) delivered[target] = deliver(target);
+                }, 1, pool);
+
+                std::size_t pending = 0;
+                for (std::size_t p = 0; p < partitions; p++) pending += awake[p] + delivered[p];
+                if (pending == 0) return step + 1;
+            }
+
+            return step;
+        }
+
+        std::vector<Value> values;
+
+    private:
+        struct Outbox {
+            std::vector<std::pair<std::size_t, Message>> messages;
+            std::unordered_map<std::size_t, Message> combined;
+        };
+
+        struct Aggregator {
+            double identity;
+            double value;
+            Reducer reduce;
+        };
+
+        std::size_t partition_of(std::size_t vertex) const { return vertex / width; }
+        std::size_t first(std::size_t partition) const { return std::min(partition * width, adjacency.size()); }
+        std::size_t last(std::size_t partition) const { return std::min(first(partition) + width, adjacency.size()); }
+
+        // Moves every buffered message for the target partition into the inboxes.
+        std::size_t deliver(std::size_t target) {
+            std::size_t count = 0;
+            for (std::size_t source = 0; source < partitions; source++) {
+                auto& outbox = outboxes[source][target];
+
+                for (auto& [to, message] : outbox.messages) inbox[to].push_back(std::move(message));
+                for (auto& [to, message] : outbox.combined) {
+                    if (inbox[to].empty()) inbox[to].push_back(std::move(message));
+                    else inbox[to][0] = combiner(inbox[to][0], message);
+                }
+
+                count += outbox.messages.size() + outbox.combined.size();
+                outbox.messages.clear();
+                outbox.combined.clear();
+            }
+            return count;
+        }
+
+        const Adjacency& adjacency;
+        ThreadPool& pool;
+        std::size_t partitions;
+        std::size_t width;
+        std::size_t step = 0;
+
+        Combiner combiner;
+        std::vector<Aggregator> aggregators;
+        std::vector<std::vector<double>> partial;
+
+        // char rather than bool so that partitions never share a byte
+        std::vector<char> active;
+        std::vector<std::vector<Message>> inbox;
+        std::vector<std::vector<Outbox>> outboxes;
+    };
+
+    // Bellman-Ford as a vertex program: a vertex that learns a shorter distance
+    // adopts it and offers it to its neighbours, then halts. Returns false if the
+    // relaxation has not settled after size() supersteps, i.e. a negative cycle is
+    // reachable from the source.
+    template<typename Adjacency>
+    bool pregel_bellman_ford(const Adjacency& adjacency, std::size_t source, ShortestPaths& paths) {
+        struct Label {
+            double distance;
+            std::size_t parent;
+        };
+
+        const auto infinity = std::numeric_limits<double>::infinity();
+        Pregel<Label, Label, Adjacency> engine(adjacency, {infinity, unreachable});
+        engine.combine_with([](const Label& a, const Label& b) { return b.distance < a.distance ? b : a; });
+
+        auto steps = engine.run([&](auto& vertex, const std::vector<Label>& messages) {
+            bool improved = vertex.superstep() == 0 && vertex.id() == source;
+            if (improved) vertex.value() = {0, unreachable};
+
+            for (auto& message : messages) {
+                if (message.distance < vertex.value().distance) {
+                    vertex.value() = message;
+                    improved = true;
+                }
+            }
+
+            if (improved) {
+                for (auto arc : vertex.neighbours()) vertex.send(arc.to, {vertex.value().distance + arc.weight, vertex.id()});
+            }
+            vertex.vote_to_halt();
+        }, adjacency.size() + 2);
+
+        paths.distance.resize(adjacency.size());
+        paths.parent.resize(adjacency.size());
+        for (std::size_t v = 0; v < adjacency.size(); v++) {
+            paths.distance[v] = engine.values[v].distance;
+            paths.parent[v] = engine.values[v].parent;
+        }
+        return steps <= adjacency.size() + 1;
+    }
+}
+
+#endif //TINYGRAPH_PREGEL_H
@@ -0,0 +1,224 @@
+#include "spanning_tree.h"
+#include "parallel.h"
+
+#include <data/snapshot.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tinygraph {
+    namespace {
+        constexpr std::size_t kruskal_limit = 1 << 16;
+        constexpr auto unset = std::numeric_limits<std::uint64_t>::max();
+
+        class DisjointSets {
+        public:
+            explicit DisjointSets(std::size_t size) : parent(size), rank(size, 0) {
+                std::iota(parent.begin(), parent.end(), 0);
+            }
+
+            std::size_t find(std::size_t v) {
+                while (parent[v] != v) {
+                    parent[v] = parent[parent[v]];
+                    v = parent[v];
+                }
+                return v;
+            }
+
+            bool unite(std::size_t a, std::size_t b) {
+                a = find(a);
+                b = find(b);
+                if (a == b) return false;
+
+                if (rank[a] < rank[b]) std::swap(a, b);
+                parent[b] = a;
+                if (rank[a] == rank[b]) rank[a]++;
+                return true;
+            }
+
+        private:
+            std::vector<std::size_t> parent;
+            std::vector<std::uint8_t> rank;
+        };
+
+        // Keeps the edge index in `target` whose (weight, index) is smallest; comparing
+        // by key rather than by a global rank needs no sort of all edges up front.
+        template<typename Less>
+        void fetch_min(std::atomic<std::uint64_t>& target, std::uint64_t edge, Less less) {
+            auto current = target.load(std::memory_order_relaxed);
+            while ((current == unset || less(edge, current)) && !target.compare_exchange_weak(current, edge, std::memory_order_relaxed)) { }
+        }
+
+        // Writes item(i) for every i in [0, count) that keep() accepts, in order, by
+        // counting per block first and then filling each block's slice in parallel.
+        template<typename Item, typename Keep>
+        std::vector<std::size_t> compact(std::size_t count, Item item, Keep keep, ThreadPool& pool) {
+            auto blocks = std::max<std::size_t>(1, std::min(count / 4096 + 1, 4 * (pool.size() + 1)));
+            auto width = (count + blocks - 1) / blocks;
+
+            std::vector<std::size_t> start(blocks + 1, 0);
+            parallel_for(0, blocks, [&](std::size_t lo, std::size_t hi) {
+                for (auto b = lo; b < hi; b++) {
+                    std::size_t kept = 0;
+                    for (auto i = b * width; i < std::min(count, (b + 1) * width); i++) kept += keep(item(i));
+                    start[b + 1] = kept;
+                }
+            }, 1, pool);
+            std::partial_sum(start.begin(), start.end(), start.begin());
+
+            std::vector<std::size_t> res(start.back());
+            parallel_for(0, blocks, [&](std::size_t lo, std::size_t hi) {
+                for (auto b = lo; b < hi; b++) {
+                    auto out = start[b];
+                    for (auto i = b * width; i < std::min(count, (b + 1) * width); i++) {
+                        auto value = item(i);
+                        if (keep(value)) res[out++] = value;
+                    }
+                }
+            }, 1, pool);
+            return res;
+        }
+    }
+
+    std::vector<std::size_t> minimum_spanning_forest(const Snapshot& snapshot, ThreadPool& pool) {
+        if (snapshot.weights.size() != snapshot.targets.size()) {
+            throw std::invalid_argument("snapshot has no edge weights");
+        }
+
+        auto n = snapshot.size();
+        auto m = snapshot.targets.size();
+
+        std::vector<std::size_t> source(m);
+        parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+            for (auto v = lo; v < hi; v++) {
+                std::fill(source.begin() + snapshot.offsets[v], source.begin() + snapshot.offsets[v + 1], v);
+            }
+        }, 1024, pool);
+
+        // (weight, edge index) is a strict order, which Boruvka needs to never close a
+        // cycle among equal weights, and Kruskal uses it too so both pick the same forest
+        auto less = [&snapshot](std::size_t a, std::size_t b) {
+            if (snapshot.weights[a] != snapshot.weights[b]) return snapshot.weights[a] < snapshot.weights[b];
+            return a < b;
+        };
+
+        std::vector<std::size_t> chosen;
+
+        if (m < kruskal_limit) {
+            std::vector<std::size_t> order(m);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), less);
+
+            DisjointSets sets(n);
+            for (auto e : order) {
+                if (sets.unite(source[e], snapshot.targets[e])) chosen.push_back(e);
+            }
+            return chosen;
+        }
+
+        // label[v] is the component of v, named after one of its vertices
+        std::vector<std::size_t> label(n), parent(n), jumped(n), picked(n);
+        std::iota(label.begin(), label.end(), 0);
+
+        auto live = compact(m, [](std::size_t e) { return e; }, [&](std::size_t e) { return source[e] != snapshot.targets[e]; }, pool);
+        std::vector<std::atomic<std::uint64_t>> best(n);
+
+        while (!live.empty()) {
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto v = lo; v < hi; v++) best[v].store(unset, std::memory_order_relaxed);
+            }, 1024, pool);
+
+            // Cheapest edge leaving each component, from either end.
+            parallel_for(0, live.size(), [&](std::size_t lo, std::size_t hi) {
+                for (auto i = lo; i < hi; i++) {
+                    auto e = live[i];
+                    fetch_min(best[label[source[e]]], e, less);
+                    fetch_min(best[label[snapshot.targets[e]]], e, less);
+                }
+            }, 1024, pool);
+
+            // Every component hooks onto the one across its cheapest edge. With a strict
+            // order the only cycles are two components picking the same edge, and there
+            // the smaller one stays a root. Each hook contributes its edge to the forest.
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto c = lo; c < hi; c++) {
+                    parent[c] = c;
+                    picked[c] = unset;
+
+                    auto e = best[c].load(std::memory_order_relaxed);
+                    if (label[c] != c || e == unset) continue;
+
+                    auto other = label[source[e]] == c ? label[snapshot.targets[e]] : label[source[e]];
+                    if (best[other].load(std::memory_order_relaxed) == e && c < other) continue;
+
+                    parent[c] = other;
+                    picked[c] = e;
+                }
+            }, 1024, pool);
+
+            auto found = compact(n, [&picked](std::size_t c) { return picked[c]; }, [](std::size_t e) { return e != unset; }, pool);
+            if (found.empty()) break;
+            chosen.insert(chosen.end(), found.begin(), found.end());
+
+            // pointer jumping until every component points at its root
+            for (bool changed = true; changed;) {
+                std::atomic<bool> moved{false};
+                parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                    bool local = false;
+                    for (auto c = lo; c < hi; c++) {
+                        jumped[c] = parent[parent[c]];
+                        local = local || jumped[c] != parent[c];
+                    }
+                    if (local) moved = true;
+                }, 1024, pool);
+                parent.swap(jumped);
+                changed = moved;
+            }
+
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto v = lo; v < hi; v++) label[v] = parent[label[v]];
+            }, 1024, pool);
+
+            live = compact(live.size(), [&live](std::size_t i) { return live[i]; }, [&](std::size_t e) {
+                return label[source[e]] != label[snapshot.targets[e]];
+            }, pool);
+        }
+
+        return chosen;
+    }
+
+    SpanningForest minimum_spanning_forest(Graph& graph, const std::string& weight_property) {
+        Snapshot snapshot(graph, weight_property);
+
+        SpanningForest res;
+        for (auto e : minimum_spanning_forest(snapshot)) {
+            auto from = std::upper_bound(snapshot.offsets.begin(), snapshot.offsets.end(), e) - snapshot.offsets.begin() - 1;
+            const auto& edge = snapshot.edges[e];
+
+            ForestEdge chosen;
+            chosen.from = snapshot.names[from];
+            chosen.to = edge->to->name;
+            chosen.weight = graph.find_value(edge->properties->at(weight_property));
+            chosen.properties = edge->properties;
+
+            res.total = std::visit([](auto total, auto weight) -> Graph::number {
+                if constexpr (std::is_same_v<decltype(total), int> && std::is_same_v<decltype(weight), int>) {
+                    // signed overflow is undefined, so a sum past int goes on as double
+                    auto sum = static_cast<long long>(total) + weight;
+                    if (sum < std::numeric_limits<int>::min() || sum > std::numeric_limits<int>::max()) return static_cast<double>(sum);
+                    return static_cast<int>(sum);
+                } else {
+                    return total + weight;
+                }
+            }, res.total, chosen.weight);
+            res.edges.push_back(std::move(chosen));
+        }
+
+        return res;
+    }
+}
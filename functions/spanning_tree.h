@@ -0,0 +1,37 @@
+#ifndef TINYGRAPH_SPANNING_TREE_H
+#define TINYGRAPH_SPANNING_TREE_H
+
+#include "parallel.h"
+#include <data/graph.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Snapshot;
+
+    struct ForestEdge {
+        std::string from;
+        std::string to;
+        Graph::number weight;
+        std::shared_ptr<std::map<std::string, std::any>> properties;
+    };
+
+    struct SpanningForest {
+        std::vector<ForestEdge> edges;
+        // int while the int weights add up within int range, double from then on
+        Graph::number total = 0;
+    };
+
+    // Edge indices (into snapshot.targets) of a minimum spanning forest, treating every
+    // edge as undirected, in no particular order. The snapshot must have been built with
+    // a weight property. Uses parallel Boruvka rounds, or plain Kruskal when there are
+    // few edges; ties are broken by edge index so both give the same forest.
+    std::vector<std::size_t> minimum_spanning_forest(const Snapshot& snapshot, ThreadPool& pool = default_pool());
+
+    // Throws std::invalid_argument if some edge has no int, float or double weight_property.
+    SpanningForest minimum_spanning_forest(Graph& graph, const std::string& weight_property);
+}
+
+#endif //TINYGRAPH_SPANNING_TREE_H
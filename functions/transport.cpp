@@ -0,0 +1,234 @@
+#include "transport.h"
+#include <cerrno>
+#include <exception>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace tinygraph {
+    LocalTransport::Hub::Hub(std::size_t ranks) : ranks(ranks) {
+        for (auto& mailbox : mailboxes) mailbox.assign(ranks, std::vector<std::vector<char>>(ranks));
+    }
+
+    LocalTransport::LocalTransport(std::shared_ptr<Hub> hub, std::size_t rank) : hub(std::move(hub)), index(rank) { }
+
+    std::vector<std::unique_ptr<Transport>> LocalTransport::group(std::size_t ranks) {
+        auto hub = std::make_shared<Hub>(ranks);
+
+        std::vector<std::unique_ptr<Transport>> res;
+        for (std::size_t r = 0; r < ranks; r++) res.push_back(std::unique_ptr<Transport>(new LocalTransport(hub, r)));
+        return res;
+    }
+
+    std::size_t LocalTransport::rank() const {
+        return this->index;
+    }
+
+    std::size_t LocalTransport::size() const {
+        return this->hub->ranks;
+    }
+
+    std::vector<std::vector<char>> LocalTransport::exchange(std::vector<std::vector<char>> outgoing) {
+        if (outgoing.size() != size()) throw std::runtime_error("exchange needs one buffer per rank");
+
+        auto& mailbox = this->hub->mailboxes[this->generation % 2];
+
+        std::unique_lock<std::mutex> lock(this->hub->mutex);
+        for (std::size_t to = 0; to < outgoing.size(); to++) mailbox[to][this->index] = std::move(outgoing[to]);
+
+        if (++this->hub->arrived == this->hub->ranks) {
+            this->hub->arrived = 0;
+            this->hub->generation++;
+            this->hub->ready.notify_all();
+        } else {
+            auto generation = this->hub->generation;
+            this->hub->ready.wait(lock, [this, generation]() { return this->hub->generation != generation; });
+        }
+        this->generation++;
+
+        std::vector<std::vector<char>> res(size());
+        for (std::size_t from = 0; from < res.size(); from++) res[from] = std::move(mailbox[this->index][from]);
+        return res;
+    }
+
+    SocketTransport::SocketTransport(std::size_t rank, std::vector<int> peers) : index(rank), peers(std::move(peers)) {
+        for (auto fd : this->peers) {
+            if (fd >= 0) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+    }
+
+    SocketTransport::~SocketTransport() {
+        for (auto fd : this->peers) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    std::size_t SocketTransport::rank() const {
+        return this->index;
+    }
+
+    std::size_t SocketTransport::size() const {
+        return this->peers.size();
+    }
+
+    std::vector<std::vector<char>> SocketTransport::exchange(std::vector<std::vector<char>> outgoing) {
+        if (outgoing.size() != size()) throw std::runtime_error("exchange needs one buffer per rank");
+
+        // every peer gets an 8 byte length and the buffer; writing and reading are
+        // interleaved with poll so that two ranks sending large buffers to each other
+        // cannot both block on full socket buffers
+        struct Progress {
+            std::uint64_t length = 0;
+            std::size_t header = 0;
+            std::size_t body = 0;
+
+            bool done() const { return header == 8 && body == length; }
+        };
+
+        std::vector<std::vector<char>> res(size());
+        std::vector<Progress> sent(size()), received(size());
+        std::size_t pending = 0;
+
+        res[this->index] = std::move(outgoing[this->index]);
+        for (std::size_t peer = 0; peer < size(); peer++) {
+            if (peer == this->index) continue;
+            sent[peer].length = outgoing[peer].size();
+            pending += 2;
+        }
+
+        auto transfer = [](int fd, char* data, std::size_t size, bool write) {
+            auto done = write ? ::send(fd, data, size, MSG_NOSIGNAL) : ::recv(fd, data, size, 0);
+            if (done < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return std::size_t(0);
+                throw std::runtime_error(std::string("socket transport: ") + std::strerror(errno));
+            }
+            if (done == 0 && !write && size > 0) throw std::runtime_error("socket transport: peer closed the connection");
+            return static_cast<std::size_t>(done);
+        };
+
+        // header first, then the body, as far as the socket takes it
+        auto step = [&transfer](int fd, Progress& progress, std::vector<char>& buffer, bool write) {
+            if (progress.header < 8) {
+                progress.header += transfer(fd, reinterpret_cast<char*>(&progress.length) + progress.header, 8 - progress.header, write);
+                if (progress.header == 8 && !write) buffer.resize(progress.length);
+            }
+            if (progress.header == 8 && progress.body < progress.length) {
+                progress.body += transfer(fd, buffer.data() + progress.body, progress.length - progress.body, write);
+            }
+            return progress.done();
+        };
+
+        std::vector<pollfd> fds;
+        std::vector<std::size_t> owners;
+        while (pending > 0) {
+            fds.clear();
+            owners.clear();
+            for (std::size_t peer = 0; peer < size(); peer++) {
+                if (peer == this->index) continue;
+
+                short events = 0;
+                if (!sent[peer].done()) events |= POLLOUT;
+                if (!received[peer].done()) events |= POLLIN;
+                if (events) {
+                    fds.push_back({this->peers[peer], events, 0});
+                    owners.push_back(peer);
+                }
+            }
+
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("socket transport: ") + std::strerror(errno));
+            }
+
+            for (std::size_t i = 0; i < fds.size(); i++) {
+                auto peer = owners[i];
+                if ((fds[i].revents & POLLERR) || ((fds[i].revents & POLLHUP) && received[peer].done())) {
+                    throw std::runtime_error("socket transport: peer closed the connection");
+                }
+
+                if ((fds[i].revents & POLLOUT) && !sent[peer].done() && step(fds[i].fd, sent[peer], outgoing[peer], true)) pending--;
+                if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) && !received[peer].done() && step(fds[i].fd, received[peer], res[peer], false)) pending--;
+            }
+        }
+
+        return res;
+    }
+
+    SocketMesh::SocketMesh(std::size_t ranks) : ranks(ranks), sockets(ranks, std::vector<int>(ranks, -1)) {
+        for (std::size_t a = 0; a < ranks; a++) {
+            for (std::size_t b = a + 1; b < ranks; b++) {
+                int pair[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+                    throw std::runtime_error(std::string("socket transport: ") + std::strerror(errno));
+                }
+                sockets[a][b] = pair[0];
+                sockets[b][a] = pair[1];
+            }
+        }
+    }
+
+    SocketMesh::~SocketMesh() {
+        for (auto& row : this->sockets) {
+            for (auto fd : row) {
+                if (fd >= 0) close(fd);
+            }
+        }
+    }
+
+    std::unique_ptr<Transport> SocketMesh::endpoint(std::size_t rank) {
+        auto peers = std::move(this->sockets[rank]);
+        this->sockets[rank].assign(this->ranks, -1);
+
+        for (auto& row : this->sockets) {
+            for (auto& fd : row) {
+                if (fd >= 0) close(fd);
+                fd = -1;
+            }
+        }
+
+        return std::unique_ptr<Transport>(new SocketTransport(rank, std::move(peers)));
+    }
+
+    int spawn_ranks(std::size_t ranks, const std::function<int(Transport&)>& body) {
+        SocketMesh mesh(ranks);
+
+        std::vector<pid_t> children;
+        for (std::size_t rank = 1; rank < ranks; rank++) {
+            auto pid = fork();
+            if (pid < 0) throw std::runtime_error(std::string("spawn_ranks: ") + std::strerror(errno));
+
+            if (pid == 0) {
+                int status = 1;
+                try {
+                    auto transport = mesh.endpoint(rank);
+                    status = body(*transport);
+                } catch (...) { }
+                _exit(status);
+            }
+            children.push_back(pid);
+        }
+
+        int res = 1;
+        std::exception_ptr error;
+        try {
+            auto transport = mesh.endpoint(0);
+            res = body(*transport);
+        } catch (...) {
+            // the children see their sockets close and fail on their own
+            error = std::current_exception();
+        }
+
+        for (auto pid : children) {
+            int status = 0;
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) { }
+            if (res == 0 && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) res = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+        }
+
+        if (error) std::rethrow_exception(error);
+        return res;
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef TINYGRAPH_TRANSPORT_H
+#define TINYGRAPH_TRANSPORT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace tinygraph {
+    // Moves bytes between the ranks of a bulk-synchronous computation. exchange() is
+    // collective: every rank calls it once per superstep with one buffer per rank
+    // (its own included, empty ones allowed) and gets back the buffers the other ranks
+    // addressed to it, indexed by sender. It returns only once every rank has sent,
+    // so it is also the superstep barrier. Failures throw std::runtime_error.
+    class Transport {
+    public:
+        virtual ~Transport() = default;
+
+        virtual std::size_t rank() const = 0;
+
+        virtual std::size_t size() const = 0;
+
+        virtual std::vector<std::vector<char>> exchange(std::vector<std::vector<char>> outgoing) = 0;
+    };
+
+    // Ranks that are threads of one process.
+    class LocalTransport : public Transport {
+    public:
+        // One transport per rank; hand each to its own thread.
+        static std::vector<std::unique_ptr<Transport>> group(std::size_t ranks);
+
+        std::size_t rank() const override;
+
+        std::size_t size() const override;
+
+        std::vector<std::vector<char>> exchange(std::vector<std::vector<char>> outgoing) override;
+
+    private:
+        struct Hub {
+            explicit Hub(std::size_t ranks);
+
+            std::size_t ranks;
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::size_t arrived = 0;
+            std::size_t generation = 0;
+            // mailboxes[generation % 2][to][from]; alternating means a fast rank can
+            // post the next superstep while a slow one still reads this one
+            std::vector<std::vector<std::vector<char>>> mailboxes[2];
+        };
+
+        LocalTransport(std::shared_ptr<Hub> hub, std::size_t rank);
+
+        std::shared_ptr<Hub> hub;
+        std::size_t index;
+        std::size_t generation = 0;
+    };
+
+    // Ranks that are processes on one machine, connected pairwise by Unix domain
+    // sockets. A SocketMesh makes all the socket pairs up front; after forking, every
+    // process takes the endpoint for its rank.
+    class SocketTransport : public Transport {
+    public:
+        ~SocketTransport() override;
+
+        std::size_t rank() const override;
+
+        std::size_t size() const override;
+
+        std::vector<std::vector<char>> exchange(std::vector<std::vector<char>> outgoing) override;
+
+    private:
+        friend class SocketMesh;
+
+        SocketTransport(std::size_t rank, std::vector<int> peers);
+
+        std::size_t index;
+        // socket to every other rank, -1 for this one
+        std::vector<int> peers;
+    };
+
+    class SocketMesh {
+    public:
+        explicit SocketMesh(std::size_t ranks);
+        ~SocketMesh();
+
+        SocketMesh(const SocketMesh&) = delete;
+        SocketMesh& operator=(const SocketMesh&) = delete;
+
+        // Closes this process's copies of every other rank's sockets; call once per
+        // process.
+        std::unique_ptr<Transport> endpoint(std::size_t rank);
+
+    private:
+        std::size_t ranks;
+        // sockets[a][b] is a's end of the pair between a and b
+        std::vector<std::vector<int>> sockets;
+    };
+
+    // Runs body in `ranks` processes joined by a SocketTransport. The calling process
+    // is rank 0; ranks 1.. are forked children that leave with _exit(body's result),
+    // so they must not rely on threads of the parent (such as the default pool).
+    // Returns rank 0's result, or the first non-zero result of a child. Children start
+    // as copies of the caller; for ranks that hold only their own shard, save_shards
+    // before and let body load_shard its rank's file.
+    int spawn_ranks(std::size_t ranks, const std::function<int(Transport&)>& body);
+
+    // One superstep of a computation whose messages are plain structs: outgoing[r] is
+    // sent to rank r, incoming receives everything addressed to this rank. Every rank
+    // also contributes `flags`; the bitwise or over all ranks is returned, which lets
+    // the ranks agree on things like termination.
+    template<typename Update>
+    std::uint8_t exchange_updates(Transport& transport, const std::vector<std::vector<Update>>& outgoing, std::vector<Update>& incoming, std::uint8_t flags) {
+        static_assert(std::is_trivially_copyable<Update>::value, "updates are sent as raw bytes");
+
+        std::vector<std::vector<char>> buffers(transport.size());
+        for (std::size_t r = 0; r < buffers.size(); r++) {
+            auto count = r < outgoing.size() ? outgoing[r].size() : 0;
+            buffers[r].resize(1 + count * sizeof(Update));
+            buffers[r][0] = static_cast<char>(flags);
+            if (count) std::memcpy(buffers[r].data() + 1, outgoing[r].data(), count * sizeof(Update));
+        }
+
+        std::uint8_t res = 0;
+        incoming.clear();
+        for (auto& buffer : transport.exchange(std::move(buffers))) {
+            if (buffer.empty()) continue;
+
+            res |= static_cast<std::uint8_t>(buffer[0]);
+            auto count = (buffer.size() - 1) / sizeof(Update);
+            auto first = incoming.size();
+            incoming.resize(first + count);
+            if (count) std::memcpy(incoming.data() + first, buffer.data() + 1, count * sizeof(Update));
+        }
+        return res;
+    }
+}
+
+#endif //TINYGRAPH_TRANSPORT_H
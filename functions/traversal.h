@@ -0,0 +1,138 @@
+#ifndef TINYGRAPH_TRAVERSAL_H
+#define TINYGRAPH_TRAVERSAL_H
+
+#include "cancellation.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace tinygraph {
+    constexpr std::size_t unreachable = std::numeric_limits<std::size_t>::max();
+
+    // The traversal templates accept any adjacency with size() and neighbours(v)
+    // returning a range of Arc, such as Snapshot or CompressedAdjacency. An optional
+    // vertex filter (for example a TypeFilter) restricts them to the vertices it
+    // accepts; the source is always visited. A cancellation token is checked between
+    // levels, passes or batches of settled vertices, and throws Cancelled out of the
+    // algorithm.
+
+    struct AllVertices {
+        bool operator()(std::size_t) const { return true; }
+    };
+
+    struct ShortestPaths {
+        std::vector<double> distance;
+        std::vector<std::size_t> parent;
+    };
+
+    // Hop count from source to every vertex, or `unreachable`.
+    template<typename Adjacency, typename Filter = AllVertices>
+    std::vector<std::size_t> bfs(const Adjacency& adjacency, std::size_t source, Filter filter = {}, const CancellationToken& token = CancellationToken::never()) {
+        std::vector<std::size_t> level(adjacency.size(), unreachable);
+        std::vector<std::size_t> queue;
+        queue.reserve(adjacency.size());
+
+        level[source] = 0;
+        queue.push_back(source);
+
+        for (std::size_t head = 0; head < queue.size(); head++) {
+            auto v = queue[head];
+            if (level[v] != level[queue[head > 0 ? head - 1 : 0]]) token.check();
+
+            for (auto arc : adjacency.neighbours(v)) {
+                if (level[arc.to] != unreachable || !filter(arc.to)) continue;
+                level[arc.to] = level[v] + 1;
+                queue.push_back(arc.to);
+            }
+        }
+
+        return level;
+    }
+
+    // Single-source shortest paths for non-negative weights. Unreached vertices keep an
+    // infinite distance; the source and unreached vertices have parent `unreachable`.
+    template<typename Adjacency, typename Filter = AllVertices>
+    ShortestPaths dijkstra(const Adjacency& adjacency, std::size_t source, Filter filter = {}, const CancellationToken& token = CancellationToken::never()) {
+        using entry = std::pair<double, std::size_t>;
+
+        ShortestPaths res;
+        res.distance.assign(adjacency.size(), std::numeric_limits<double>::infinity());
+        res.parent.assign(adjacency.size(), unreachable);
+
+        std::priority_queue<entry, std::vector<entry>, std::greater<>> queue;
+        res.distance[source] = 0;
+        queue.emplace(0.0, source);
+
+        for (std::size_t settled = 0; !queue.empty();) {
+            auto [distance, v] = queue.top();
+            queue.pop();
+            if (distance > res.distance[v]) continue;
+            if (++settled % 1024 == 0) token.check();
+
+            for (auto arc : adjacency.neighbours(v)) {
+                if (!filter(arc.to)) continue;
+
+                auto candidate = distance + arc.weight;
+                if (candidate < res.distance[arc.to]) {
+                    res.distance[arc.to] = candidate;
+                    res.parent[arc.to] = v;
+                    queue.emplace(candidate, arc.to);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    // Single-source shortest paths allowing negative weights. Returns false, leaving
+    // `paths` unspecified, if a negative cycle is reachable from the source.
+    template<typename Adjacency, typename Filter = AllVertices>
+    bool bellman_ford(const Adjacency& adjacency, std::size_t source, ShortestPaths& paths, Filter filter = {}, const CancellationToken& token = CancellationToken::never()) {
+        auto n = adjacency.size();
+        paths.distance.assign(n, std::numeric_limits<double>::infinity());
+        paths.parent.assign(n, unreachable);
+        paths.distance[source] = 0;
+
+        for (std::size_t pass = 0; pass < n; pass++) {
+            token.check();
+            bool relaxed = false;
+
+            for (std::size_t v = 0; v < n; v++) {
+                if (paths.distance[v] == std::numeric_limits<double>::infinity()) continue;
+
+                for (auto arc : adjacency.neighbours(v)) {
+                    if (!filter(arc.to)) continue;
+
+                    auto candidate = paths.distance[v] + arc.weight;
+                    if (candidate < paths.distance[arc.to]) {
+                        paths.distance[arc.to] = candidate;
+                        paths.parent[arc.to] = v;
+                        relaxed = true;
+                    }
+                }
+            }
+
+            if (!relaxed) return true;
+        }
+
+        return false;
+    }
+
+    // Vertex ids from the source of `paths` to target, or empty if target was not reached.
+    inline std::vector<std::size_t> path_to(const ShortestPaths& paths, std::size_t target) {
+        std::vector<std::size_t> res;
+        if (paths.distance[target] == std::numeric_limits<double>::infinity()) return res;
+
+        for (auto v = target; v != unreachable; v = paths.parent[v]) {
+            res.push_back(v);
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+}
+
+#endif //TINYGRAPH_TRAVERSAL_H
@@ -0,0 +1,235 @@
+#include "triangles.h"
+#include "intersect.h"
+#include "parallel.h"
+
+#include <data/graph.h>
+#include <data/snapshot.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+
+namespace tinygraph {
+    namespace {
+        // Simple undirected adjacency with vertices relabelled by ascending degree. List r
+        // holds the ranks of r's neighbours in increasing order; the ones above r start
+        // at higher[r], so neighbours[higher[r] .. offsets[r + 1]) is r's oriented list.
+        struct RankedAdjacency {
+            std::vector<std::size_t> vertex;
+            std::vector<std::size_t> offsets;
+            std::vector<std::uint32_t> neighbours;
+            std::vector<std::size_t> higher;
+
+            std::size_t size() const { return vertex.size(); }
+            std::size_t degree(std::size_t r) const { return offsets[r + 1] - offsets[r]; }
+            const std::uint32_t* begin(std::size_t r) const { return neighbours.data() + offsets[r]; }
+        };
+
+        RankedAdjacency rank_by_degree(const Snapshot& snapshot) {
+            auto n = snapshot.size();
+
+            std::vector<std::size_t> offsets(n + 1, 0);
+            for (std::size_t v = 0; v < n; v++) {
+                for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                    auto w = snapshot.targets[e];
+                    if (w == v) continue;
+                    offsets[v + 1]++;
+                    offsets[w + 1]++;
+                }
+            }
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<std::uint32_t> symmetric(offsets[n]);
+            {
+                auto fill = offsets;
+                for (std::size_t v = 0; v < n; v++) {
+                    for (auto e = snapshot.offsets[v]; e < snapshot.offsets[v + 1]; e++) {
+                        auto w = snapshot.targets[e];
+                        if (w == v) continue;
+                        symmetric[fill[v]++] = static_cast<std::uint32_t>(w);
+                        symmetric[fill[w]++] = static_cast<std::uint32_t>(v);
+                    }
+                }
+            }
+
+            std::vector<std::size_t> degree(n);
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto v = lo; v < hi; v++) {
+                    auto first = symmetric.begin() + offsets[v];
+                    auto last = symmetric.begin() + offsets[v + 1];
+                    std::sort(first, last);
+                    degree[v] = std::unique(first, last) - first;
+                }
+            });
+
+            RankedAdjacency res;
+            res.vertex.resize(n);
+            std::iota(res.vertex.begin(), res.vertex.end(), 0);
+            std::stable_sort(res.vertex.begin(), res.vertex.end(), [&degree](std::size_t a, std::size_t b) {
+                return degree[a] < degree[b];
+            });
+
+            std::vector<std::uint32_t> rank(n);
+            res.offsets.assign(n + 1, 0);
+            for (std::size_t r = 0; r < n; r++) {
+                rank[res.vertex[r]] = static_cast<std::uint32_t>(r);
+                res.offsets[r + 1] = res.offsets[r] + degree[res.vertex[r]];
+            }
+
+            res.neighbours.resize(res.offsets[n]);
+            res.higher.resize(n);
+            parallel_for(0, n, [&](std::size_t lo, std::size_t hi) {
+                for (auto r = lo; r < hi; r++) {
+                    auto v = res.vertex[r];
+                    auto out = res.neighbours.begin() + res.offsets[r];
+                    for (std::size_t i = 0; i < degree[v]; i++) {
+                        out[i] = rank[symmetric[offsets[v] + i]];
+                    }
+                    std::sort(out, out + degree[v]);
+                    res.higher[r] = std::upper_bound(out, out + degree[v], static_cast<std::uint32_t>(r)) - res.neighbours.begin();
+                }
+            });
+
+            return res;
+        }
+
+        // Every triangle at r shows up twice among the intersections of r's list with
+        // its neighbours' lists.
+        std::vector<std::size_t> triangles_per_vertex(const RankedAdjacency& adj) {
+            std::vector<std::size_t> res(adj.size(), 0);
+
+            parallel_for(0, adj.size(), [&](std::size_t lo, std::size_t hi) {
+                for (auto r = lo; r < hi; r++) {
+                    std::size_t twice = 0;
+                    for (std::size_t i = 0; i < adj.degree(r); i++) {
+                        auto u = adj.begin(r)[i];
+                        twice += intersect_count(adj.begin(r), adj.degree(r), adj.begin(u), adj.degree(u));
+                    }
+                    res[adj.vertex[r]] = twice / 2;
+                }
+            }, 256);
+
+            return res;
+        }
+    }
+
+    std::size_t triangle_count(const Snapshot& snapshot) {
+        auto adj = rank_by_degree(snapshot);
+        std::atomic<std::size_t> total{0};
+
+        // Each triangle is counted once, from its two lowest-ranked corners.
+        parallel_for(0, adj.size(), [&](std::size_t lo, std::size_t hi) {
+            std::size_t local = 0;
+            for (auto r = lo; r < hi; r++) {
+                auto r_first = adj.neighbours.data() + adj.higher[r];
+                auto r_size = adj.offsets[r + 1] - adj.higher[r];
+
+                for (std::size_t i = 0; i < r_size; i++) {
+                    auto u = r_first[i];
+                    local += intersect_count(r_first, r_size, adj.neighbours.data() + adj.higher[u], adj.offsets[u + 1] - adj.higher[u]);
+                }
+            }
+            total += local;
+        }, 256);
+
+        return total;
+    }
+
+    std::vector<std::size_t> vertex_triangles(const Snapshot& snapshot) {
+        return triangles_per_vertex(rank_by_degree(snapshot));
+    }
+
+    std::vector<double> clustering_coefficients(const Snapshot& snapshot) {
+        auto adj = rank_by_degree(snapshot);
+        auto triangles = triangles_per_vertex(adj);
+        std::vector<double> res(adj.size(), 0.0);
+
+        for (std::size_t r = 0; r < adj.size(); r++) {
+            auto d = static_cast<double>(adj.degree(r));
+            auto v = adj.vertex[r];
+            if (d >= 2) res[v] = 2.0 * static_cast<double>(triangles[v]) / (d * (d - 1));
+        }
+
+        return res;
+    }
+
+    // Batagelj-Zaversnik: repeatedly peel a vertex of minimum remaining degree, keeping
+    // vertices bucketed by degree so the whole decomposition is linear.
+    std::vector<std::size_t> core_numbers(const Snapshot& snapshot) {
+        auto adj = rank_by_degree(snapshot);
+        auto n = adj.size();
+
+        std::vector<std::size_t> degree(n);
+        std::size_t max_degree = 0;
+        for (std::size_t r = 0; r < n; r++) {
+            degree[r] = adj.degree(r);
+            max_degree = std::max(max_degree, degree[r]);
+        }
+
+        std::vector<std::size_t> bin(max_degree + 1, 0);
+        for (auto d : degree) bin[d]++;
+        for (std::size_t d = 0, start = 0; d <= max_degree; d++) {
+            auto size = bin[d];
+            bin[d] = start;
+            start += size;
+        }
+
+        std::vector<std::size_t> order(n);
+        std::vector<std::size_t> position(n);
+        for (std::size_t r = 0; r < n; r++) {
+            position[r] = bin[degree[r]]++;
+            order[position[r]] = r;
+        }
+        for (std::size_t d = max_degree; d > 0; d--) bin[d] = bin[d - 1];
+        if (!bin.empty()) bin[0] = 0;
+
+        for (std::size_t i = 0; i < n; i++) {
+            auto r = order[i];
+            for (std::size_t k = 0; k < adj.degree(r); k++) {
+                auto u = adj.begin(r)[k];
+                if (degree[u] <= degree[r]) continue;
+
+                auto du = degree[u];
+                auto first = order[bin[du]];
+                if (u != first) {
+                    std::swap(order[position[u]], order[bin[du]]);
+                    std::swap(position[u], position[first]);
+                }
+                bin[du]++;
+                degree[u]--;
+            }
+        }
+
+        std::vector<std::size_t> res(n);
+        for (std::size_t r = 0; r < n; r++) res[adj.vertex[r]] = degree[r];
+        return res;
+    }
+
+    std::map<std::string, std::size_t> vertex_triangles(Graph& graph) {
+        Snapshot snapshot(graph);
+        auto triangles = vertex_triangles(snapshot);
+
+        std::map<std::string, std::size_t> res;
+        for (std::size_t v = 0; v < snapshot.size(); v++) res[snapshot.names[v]] = triangles[v];
+        return res;
+    }
+
+    std::map<std::string, double> clustering_coefficients(Graph& graph) {
+        Snapshot snapshot(graph);
+        auto coefficients = clustering_coefficients(snapshot);
+
+        std::map<std::string, double> res;
+        for (std::size_t v = 0; v < snapshot.size(); v++) res[snapshot.names[v]] = coefficients[v];
+        return res;
+    }
+
+    std::map<std::string, std::size_t> core_numbers(Graph& graph) {
+        Snapshot snapshot(graph);
+        auto cores = core_numbers(snapshot);
+
+        std::map<std::string, std::size_t> res;
+        for (std::size_t v = 0; v < snapshot.size(); v++) res[snapshot.names[v]] = cores[v];
+        return res;
+    }
+}
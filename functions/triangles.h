@@ -0,0 +1,33 @@
+#ifndef TINYGRAPH_TRIANGLES_H
+#define TINYGRAPH_TRIANGLES_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tinygraph {
+    class Graph;
+    class Snapshot;
+
+    // All of these treat the graph as simple and undirected: edge direction, parallel
+    // edges and self loops are ignored. Per-vertex results are indexed by snapshot id.
+
+    std::size_t triangle_count(const Snapshot& snapshot);
+
+    std::vector<std::size_t> vertex_triangles(const Snapshot& snapshot);
+
+    // 2 * triangles / (degree * (degree - 1)), or 0 for vertices with fewer than two
+    // neighbours.
+    std::vector<double> clustering_coefficients(const Snapshot& snapshot);
+
+    std::vector<std::size_t> core_numbers(const Snapshot& snapshot);
+
+    std::map<std::string, std::size_t> vertex_triangles(Graph& graph);
+
+    std::map<std::string, double> clustering_coefficients(Graph& graph);
+
+    std::map<std::string, std::size_t> core_numbers(Graph& graph);
+}
+
+#endif //TINYGRAPH_TRIANGLES_H
@@ -4,7 +4,10 @@
 
 #include <string>
 #include <any>
+#include <cstdio>
+#include <cstdlib>
 #include <typeinfo>
+#include "util.h"
 
 namespace tinygraph {
     std::string any_to_str(const std::any* val) {
@@ -14,10 +17,34 @@ namespace tinygraph {
             return std::any_cast<std::string>(*val);
         } else if (val->type() == typeid(float)) {
             return std::to_string(std::any_cast<float>(*val));
+        } else if (val->type() == typeid(double)) {
+            return double_to_str(std::any_cast<double>(*val));
         } else if (val->type() == typeid(const char*)) {
             return std::any_cast<const char*>(*val);
         } else {
             return "<value>";
         }
     }
+
+    std::string double_to_str(double val) {
+        char buffer[32];
+        for (int precision = 15; precision <= 17; precision++) {
+            std::snprintf(buffer, sizeof(buffer), "%.*g", precision, val);
+            if (std::strtod(buffer, nullptr) == val) break;
+        }
+        return buffer;
+    }
+
+    bool any_to_double(const std::any* val, double& out) {
+        if (val->type() == typeid(int)) {
+            out = std::any_cast<int>(*val);
+        } else if (val->type() == typeid(float)) {
+            out = std::any_cast<float>(*val);
+        } else if (val->type() == typeid(double)) {
+            out = std::any_cast<double>(*val);
+        } else {
+            return false;
+        }
+        return true;
+    }
 }
@@ -10,6 +10,11 @@
 
 namespace tinygraph {
     std::string any_to_str(const std::any* val);
+
+    // Shortest decimal form that reads back as the same double.
+    std::string double_to_str(double val);
+
+    bool any_to_double(const std::any* val, double& out);
 }
 
 #endif //TINYGRAPH_UTIL_H
@@ -0,0 +1,106 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+std::unique_ptr<tinygraph::Graph> regional(std::size_t vertices, std::size_t stride, bool negative) {
+  auto town = tinygraph::typestore_add("town");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (std::size_t v = 0; v < vertices; v++)
+    g->add("t" + std::to_string(1000 + v), town);
+
+  // a directed ring plus chords; with negative set every weight w(u, v) becomes
+  // w + p(u) - p(v), which makes many edges negative but leaves every cycle as long as before
+  auto potential = [negative](std::size_t v) { return negative ? int((v * 37) % 50) : 0; };
+  for (std::size_t v = 0; v < vertices; v++) {
+    auto name = "t" + std::to_string(1000 + v);
+    auto next = (v + 1) % vertices;
+    (*g->link(name, "t" + std::to_string(1000 + next), false))[DISTANCE] = 50 + potential(v) - potential(next);
+    for (std::size_t s = 1; s * stride < vertices; s++) {
+      auto to = (v * 7 + s * stride) % vertices;
+      if (to == v)
+        continue;
+      int weight = int((v * 13 + s * 5) % 40) + 1 + potential(v) - potential(to);
+      (*g->link(name, "t" + std::to_string(1000 + to), false))[DISTANCE] = weight;
+    }
+  }
+  return g;
+}
+
+bool same_distances(const tinygraph::DistanceMatrix &a, const tinygraph::DistanceMatrix &b) {
+  return a.size == b.size && a.distance == b.distance;
+}
+
+bool path_is_shortest(const tinygraph::Snapshot &snapshot, const tinygraph::DistanceMatrix &matrix, std::size_t from, std::size_t to) {
+  auto path = matrix.path(from, to);
+  if (path.empty())
+    return matrix.at(from, to) == std::numeric_limits<double>::infinity();
+
+  double length = 0;
+  for (std::size_t i = 0; i + 1 < path.size(); i++) {
+    double best = std::numeric_limits<double>::infinity();
+    for (auto arc : snapshot.neighbours(path[i]))
+      if (arc.to == path[i + 1])
+        best = std::min(best, arc.weight);
+    length += best;
+  }
+  return path.front() == from && path.back() == to && length == matrix.at(from, to);
+}
+
+bool dense_example() {
+  auto g = regional(150, 3, false);
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+
+  tinygraph::DistanceMatrix blocked, johnson;
+  bool ok = tinygraph::all_pairs_shortest_paths(snapshot, blocked, true, tinygraph::ApspMethod::floyd_warshall);
+  ok = ok && tinygraph::all_pairs_shortest_paths(snapshot, johnson, true, tinygraph::ApspMethod::johnson);
+  ok = ok && same_distances(blocked, johnson);
+
+  for (std::size_t source = 0; source < snapshot.size(); source += 7) {
+    auto paths = tinygraph::dijkstra(snapshot, source);
+    for (std::size_t v = 0; v < snapshot.size(); v++) {
+      ok = ok && blocked.at(source, v) == paths.distance[v];
+      ok = ok && path_is_shortest(snapshot, blocked, source, v) && path_is_shortest(snapshot, johnson, source, v);
+    }
+  }
+
+  std::cout << "dense example" << std::endl;
+  std::cout << "\t" << blocked.names[0] << " -> " << blocked.names[100] << " = " << blocked.at(0, 100) << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool negative_example() {
+  auto g = regional(90, 11, true);
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+
+  tinygraph::DistanceMatrix blocked, johnson;
+  bool ok = tinygraph::all_pairs_shortest_paths(snapshot, blocked, false, tinygraph::ApspMethod::floyd_warshall);
+  ok = ok && tinygraph::all_pairs_shortest_paths(*g, DISTANCE, johnson, true, tinygraph::ApspMethod::johnson);
+  ok = ok && g->negative_cycle == tinygraph::Graph::non_negative && same_distances(blocked, johnson);
+
+  for (std::size_t source = 0; source < snapshot.size(); source += 11) {
+    tinygraph::ShortestPaths paths;
+    ok = ok && tinygraph::bellman_ford(snapshot, source, paths);
+    for (std::size_t v = 0; v < snapshot.size(); v++)
+      ok = ok && johnson.at(source, v) == paths.distance[v] && path_is_shortest(snapshot, johnson, source, v);
+  }
+
+  // a negative cycle is reported by both methods and on the graph
+  (*g->link("t1005", "t1004", false))[DISTANCE] = -200;
+  ok = ok && !tinygraph::all_pairs_shortest_paths(*g, DISTANCE, johnson) && g->negative_cycle == tinygraph::Graph::negative;
+  ok = ok && !tinygraph::all_pairs_shortest_paths(*g, DISTANCE, blocked, false, tinygraph::ApspMethod::floyd_warshall);
+
+  std::cout << "negative example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = dense_example();
+  ok = negative_example() && ok;
+  return ok ? 0 : 1;
+}
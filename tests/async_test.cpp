@@ -0,0 +1,102 @@
+#include "../tinygraph.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+using namespace std::chrono_literals;
+
+// a chain whose edges point from higher to lower ids, so that Bellman-Ford, which scans
+// vertices by increasing id, needs one pass per vertex
+std::unique_ptr<tinygraph::Graph> chain(std::size_t vertices) {
+  auto stop = tinygraph::typestore_add("stop");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (std::size_t v = 0; v < vertices; v++)
+    g->add("s" + std::to_string(100000 + v), stop);
+  for (std::size_t v = 1; v < vertices; v++)
+    (*g->link("s" + std::to_string(100000 + v), "s" + std::to_string(100000 + v - 1), false))[DISTANCE] = 1;
+  return g;
+}
+
+// stands in for std::coroutine_handle
+struct Handle {
+  std::atomic<bool> *resumed;
+  void resume() { *resumed = true; }
+};
+
+template <typename T> bool throws_cancelled(tinygraph::Query<T> &query) {
+  try {
+    query.get();
+  } catch (const tinygraph::Cancelled &) {
+    return true;
+  }
+  return false;
+}
+
+bool deadline_example() {
+  auto g = chain(20000);
+  auto snapshot = std::make_shared<tinygraph::Snapshot>(*g, DISTANCE);
+  auto last = snapshot->size() - 1;
+
+  tinygraph::Executor executor(2);
+
+  // an ordinary query
+  auto levels = executor.submit([snapshot, last](const tinygraph::CancellationToken &token) {
+    return tinygraph::bfs(*snapshot, last, tinygraph::AllVertices(), token);
+  });
+  bool ok = levels.get()[0] == last;
+
+  // Bellman-Ford on the chain takes |V| passes; the deadline cuts it short
+  auto start = std::chrono::steady_clock::now();
+  auto slow = executor.submit([snapshot, last](const tinygraph::CancellationToken &token) {
+    tinygraph::ShortestPaths paths;
+    tinygraph::bellman_ford(*snapshot, last, paths, tinygraph::AllVertices(), token);
+    return paths;
+  }, tinygraph::CancellationToken::after(30ms));
+  ok = ok && throws_cancelled(slow);
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  ok = ok && elapsed < 2000;
+
+  // cancelled by the caller, and the graph's own bellman_ford
+  auto on_graph = executor.submit([&g](const tinygraph::CancellationToken &token) {
+    return g->bellman_ford("s119999", DISTANCE, {}, token);
+  });
+  std::this_thread::sleep_for(10ms);
+  on_graph.cancel();
+  ok = ok && throws_cancelled(on_graph) && g->distances.empty();
+
+  // a query whose token is cancelled before it starts never runs
+  std::atomic<bool> ran{false};
+  tinygraph::CancellationToken cancelled;
+  cancelled.cancel();
+  auto skipped = executor.submit([&ran](const tinygraph::CancellationToken &) {
+    ran = true;
+    return 0;
+  }, cancelled);
+  ok = ok && throws_cancelled(skipped) && !ran;
+
+  // awaiting: suspend while pending, resume from the executor once done
+  std::atomic<bool> release{false}, resumed{false};
+  auto awaited = executor.submit([&release](const tinygraph::CancellationToken &) {
+    while (!release)
+      std::this_thread::sleep_for(1ms);
+    return 42;
+  });
+  ok = ok && !awaited.await_ready() && awaited.await_suspend(Handle{&resumed});
+  release = true;
+  awaited.wait();
+  ok = ok && resumed && awaited.await_resume() == 42;
+
+  std::cout << "deadline example" << std::endl;
+  std::cout << "\tbellman ford stopped after " << (elapsed < 2000 ? "less than 2 s" : "too long") << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return deadline_example() ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "../tinygraph.h"
 #include <climits>
+#include <limits>
 #include <iostream>
 #include <memory>
 
@@ -0,0 +1,79 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <thread>
+
+using edge_set = std::multiset<std::tuple<std::string, std::string, int>>;
+
+edge_set edges_of(tinygraph::Graph &g) {
+  edge_set res;
+  for (auto &[name, vertex] : g.vertices) {
+    for (auto &edge : vertex->connections) {
+      res.insert({name, edge->to->name, std::any_cast<int>(edge->properties->at("weight"))});
+    }
+  }
+  return res;
+}
+
+std::string name_of(std::size_t i) { return "v" + std::to_string(i); }
+
+bool ingest_example() {
+  auto node = tinygraph::typestore_add("node");
+  const std::size_t vertices = 20000, threads = 4;
+
+  tinygraph::GraphBuilder builder;
+  auto start = std::chrono::steady_clock::now();
+
+  // every thread adds all vertices (so adds race on every name) and links its share of them
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      for (std::size_t i = 0; i < vertices; i++)
+        builder.add(name_of((i + t * 997) % vertices), node);
+      for (std::size_t i = t; i < vertices; i += threads) {
+        builder.link(name_of(i), name_of((i + 1) % vertices), false)->insert({"weight", int(i)});
+        builder.link(name_of(i), name_of((i * 7) % vertices), true)->insert({"weight", int(i)});
+      }
+    });
+  }
+  for (auto &worker : workers)
+    worker.join();
+
+  bool ok = builder.size() == vertices && builder.link("v1", "missing", false) == nullptr;
+
+  auto g = builder.seal();
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  auto serial = std::make_unique<tinygraph::Graph>();
+  for (std::size_t i = 0; i < vertices; i++)
+    serial->add(name_of(i), node);
+  for (std::size_t i = 0; i < vertices; i++) {
+    serial->link(name_of(i), name_of((i + 1) % vertices), false)->insert({"weight", int(i)});
+    serial->link(name_of(i), name_of((i * 7) % vertices), true)->insert({"weight", int(i)});
+  }
+
+  ok = ok && builder.size() == 0 && g->vertices.size() == vertices;
+  ok = ok && g->vertices_of(node).size() == vertices;
+  ok = ok && edges_of(*g) == edges_of(*serial);
+
+  // the sealed graph is an ordinary graph
+  g->get_vertex("v5")->add_prop("colour", std::string("red"));
+  g->create_index("colour", tinygraph::IndexKind::hash);
+  ok = ok && g->find("colour", "red").size() == 1;
+  tinygraph::Snapshot snapshot(*g, "weight");
+  auto levels = tinygraph::bfs(snapshot, snapshot.id("v0"));
+  ok = ok && std::count(levels.begin(), levels.end(), tinygraph::unreachable) == 0;
+
+  std::cout << "ingest example" << std::endl;
+  std::cout << "\t" << vertices << " vertices from " << threads << " threads in " << elapsed << " ms" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return ingest_example() ? 0 : 1;
+}
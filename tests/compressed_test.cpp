@@ -0,0 +1,139 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+
+static constexpr char DISTANCE[] = "distance";
+
+bool random_example() {
+  auto node = tinygraph::typestore_add("node");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  constexpr int vertices = 3000;
+  std::mt19937 random(5);
+  std::uniform_int_distribution<int> pick(0, vertices - 1);
+  std::uniform_int_distribution<int> near(-20, 20);
+  std::uniform_int_distribution<int> weight(1, 100);
+
+  for (int i = 0; i < vertices; i++) {
+    g->add(std::to_string(i), node);
+  }
+
+  // mostly local edges plus some long jumps, so both short and long gaps get encoded
+  for (int i = 0; i < 30000; i++) {
+    int from = pick(random);
+    int to = i % 10 == 0 ? pick(random) : std::clamp(from + near(random), 0, vertices - 1);
+    auto linkprops = g->link(std::to_string(from), std::to_string(to), false);
+    linkprops->insert({DISTANCE, weight(random)});
+  }
+
+  tinygraph::Snapshot snapshot(*g, DISTANCE, tinygraph::Ordering::rcm);
+  tinygraph::CompressedAdjacency compressed(snapshot);
+
+  bool ok = compressed.size() == snapshot.size() && compressed.edge_count() == snapshot.targets.size();
+
+  for (std::size_t v = 0; v < snapshot.size() && ok; v++) {
+    std::vector<std::pair<std::size_t, double>> expected, decoded;
+    for (auto arc : snapshot.neighbours(v))
+      expected.push_back({arc.to, arc.weight});
+    for (auto arc : compressed.neighbours(v))
+      decoded.push_back({arc.to, arc.weight});
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](auto &a, auto &b) { return a.first < b.first; });
+    ok = expected == decoded && compressed.names[v] == snapshot.names[v];
+  }
+
+  auto source = snapshot.id("0");
+  ok = ok && tinygraph::bfs(snapshot, source) == tinygraph::bfs(compressed, source);
+
+  auto expected = tinygraph::dijkstra(snapshot, source);
+  auto decoded = tinygraph::dijkstra(compressed, source);
+  ok = ok && expected.distance == decoded.distance;
+
+  // arcs sorted by reorder() keep their positions, so no edge ids are stored; in name
+  // order they move and Arc.edge still leads back to the snapshot edge
+  for (auto ordering : {tinygraph::Ordering::rcm, tinygraph::Ordering::name}) {
+    tinygraph::Snapshot ordered(*g, DISTANCE, ordering);
+    tinygraph::CompressedAdjacency again(ordered);
+    for (std::size_t v = 0; v < ordered.size() && ok; v++) {
+      for (auto arc : again.neighbours(v)) {
+        ok = ok && arc.edge >= ordered.offsets[v] && arc.edge < ordered.offsets[v + 1];
+        ok = ok && ordered.targets[arc.edge] == arc.to && ordered.weights[arc.edge] == arc.weight;
+      }
+    }
+  }
+
+  auto plain = [](const tinygraph::Snapshot &snapshot) {
+    return snapshot.offsets.size() * sizeof(std::size_t) + snapshot.targets.size() * sizeof(std::size_t) +
+           snapshot.weights.size() * sizeof(double);
+  };
+  tinygraph::Snapshot unweighted(*g, "", tinygraph::Ordering::rcm);
+  tinygraph::CompressedAdjacency bare(unweighted);
+
+  std::cout << "random example" << std::endl;
+  std::cout << "\tweighted: snapshot arrays " << plain(snapshot) << " bytes, compressed " << compressed.memory_bytes()
+            << " bytes" << std::endl;
+  std::cout << "\tunweighted: snapshot arrays " << plain(unweighted) << " bytes, compressed " << bare.memory_bytes()
+            << " bytes" << std::endl;
+  ok = ok && compressed.memory_bytes() * 4 < plain(snapshot) && bare.memory_bytes() * 5 < plain(unweighted) * 2;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool precision_example() {
+  auto node = tinygraph::typestore_add("node");
+  tinygraph::Graph g;
+  for (auto name : {"a", "b", "c"})
+    g.add(name, node);
+
+  // neither weight has an exact float representation
+  g.link("a", "b", false)->insert({DISTANCE, 16777217});
+  g.link("b", "c", false)->insert({DISTANCE, 0.1});
+
+  tinygraph::Snapshot snapshot(g, DISTANCE);
+  tinygraph::CompressedAdjacency compressed(snapshot);
+
+  auto expected = tinygraph::dijkstra(snapshot, snapshot.id("a"));
+  auto decoded = tinygraph::dijkstra(compressed, snapshot.id("a"));
+  bool ok = decoded.distance == expected.distance && decoded.distance[snapshot.id("c")] == 16777217 + 0.1;
+
+  // more distinct weights than one byte codes, and more than two byte codes, hold even
+  // when the codes widen between vertices; b's edge ids come reversed, so they are
+  // recorded from its first arc on
+  for (std::size_t distinct : {300, 70000}) {
+    tinygraph::CompressedAdjacency::Builder builder(true);
+    std::vector<tinygraph::Arc> first, second;
+    for (std::size_t i = 0; i < distinct / 2; i++)
+      first.push_back({1, 1.0 / 3 + i, i});
+    for (std::size_t i = distinct / 2; i < distinct; i++)
+      second.push_back({0, 1.0 / 3 + i, distinct / 2 + distinct - 1 - i});
+    builder.add("a", first);
+    builder.add("b", second);
+    auto many = builder.build();
+
+    std::size_t i = 0;
+    for (std::size_t v = 0; v < 2; v++) {
+      for (auto arc : many.neighbours(v)) {
+        auto edge = v == 0 ? i : distinct / 2 + distinct - 1 - i;
+        ok = ok && arc.weight == 1.0 / 3 + i && arc.edge == edge && arc.to == 1 - v;
+        i++;
+      }
+    }
+    ok = ok && i == distinct;
+  }
+
+  std::cout << "precision example" << std::endl;
+  std::cout.precision(17);
+  std::cout << "\ta -> c = " << decoded.distance[snapshot.id("c")] << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = random_example();
+  ok = precision_example() && ok;
+  return ok ? 0 : 1;
+}
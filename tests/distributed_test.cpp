@@ -0,0 +1,204 @@
+#include "../tinygraph.h"
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+static constexpr char DISTANCE[] = "distance";
+
+struct Result {
+  std::size_t vertex;
+  double distance;
+  std::size_t level;
+};
+
+std::string name_of(std::size_t row, std::size_t column) {
+  return "r" + std::to_string(100 + row) + "c" + std::to_string(100 + column);
+}
+
+// a directed grid with some long diagonals, so that every partition cuts edges
+std::unique_ptr<tinygraph::Graph> grid(std::size_t rows, std::size_t columns) {
+  auto node = tinygraph::typestore_add("node");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (std::size_t r = 0; r < rows; r++)
+    for (std::size_t c = 0; c < columns; c++)
+      g->add(name_of(r, c), node);
+
+  for (std::size_t r = 0; r < rows; r++) {
+    for (std::size_t c = 0; c < columns; c++) {
+      auto weight = int((r * 7 + c * 3) % 11 + 1);
+      if (c + 1 < columns)
+        (*g->link(name_of(r, c), name_of(r, c + 1), (r + c) % 3 == 0))[DISTANCE] = weight;
+      if (r + 1 < rows)
+        (*g->link(name_of(r, c), name_of(r + 1, c), false))[DISTANCE] = weight + 2;
+      if (r + 3 < rows && c + 5 < columns && (r * c) % 4 == 1)
+        (*g->link(name_of(r, c), name_of(r + 3, c + 5), false))[DISTANCE] = 9;
+    }
+  }
+  return g;
+}
+
+// runs both algorithms on one rank and collects every rank's results on rank 0
+bool run_rank(const tinygraph::Shard &shard, tinygraph::Transport &transport, std::size_t source,
+              std::vector<Result> &gathered) {
+  auto levels = tinygraph::distributed_bfs(shard, transport, source);
+  tinygraph::ShortestPaths paths;
+  bool ok = tinygraph::distributed_shortest_paths(shard, transport, source, paths);
+
+  std::vector<std::vector<Result>> outgoing(transport.size());
+  for (std::size_t v = 0; v < shard.owned; v++)
+    outgoing[0].push_back({shard.global[v], paths.distance[v], levels[v]});
+  tinygraph::exchange_updates(transport, outgoing, gathered, 0);
+  return ok;
+}
+
+bool matches(const tinygraph::Snapshot &snapshot, std::size_t source, const std::vector<Result> &gathered) {
+  auto levels = tinygraph::bfs(snapshot, source);
+  auto paths = tinygraph::dijkstra(snapshot, source);
+
+  bool ok = gathered.size() == snapshot.size();
+  for (auto &result : gathered)
+    ok = ok && result.level == levels[result.vertex] && result.distance == paths.distance[result.vertex];
+  return ok;
+}
+
+bool partitioned_grid_example() {
+  auto g = grid(12, 20);
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  const std::size_t parts = 4;
+  auto source = snapshot.id(name_of(0, 0));
+
+  auto hashed = tinygraph::partition(snapshot, parts, tinygraph::PartitionStrategy::hash);
+  auto greedy = tinygraph::partition(snapshot, parts, tinygraph::PartitionStrategy::greedy);
+
+  std::vector<std::size_t> load(parts);
+  for (auto owner : greedy)
+    load[owner]++;
+  bool ok = *std::max_element(load.begin(), load.end()) <= (snapshot.size() + parts - 1) / parts;
+  ok = ok && tinygraph::edge_cut(snapshot, greedy) < tinygraph::edge_cut(snapshot, hashed);
+
+  std::cout << "partitioned grid example" << std::endl;
+  std::cout << "\tedge cut: hash " << tinygraph::edge_cut(snapshot, hashed) << ", greedy "
+            << tinygraph::edge_cut(snapshot, greedy) << " of " << snapshot.targets.size() << std::endl;
+
+  // ranks as threads
+  for (auto &owner : {hashed, greedy}) {
+    auto shards = tinygraph::make_shards(snapshot, owner, parts);
+    auto transports = tinygraph::LocalTransport::group(parts);
+    std::vector<Result> gathered;
+    std::vector<char> done(parts, false);
+
+    std::vector<std::thread> ranks;
+    for (std::size_t r = 1; r < parts; r++) {
+      ranks.emplace_back([&, r]() {
+        std::vector<Result> ignored;
+        done[r] = run_rank(shards[r], *transports[r], source, ignored);
+      });
+    }
+    done[0] = run_rank(shards[0], *transports[0], source, gathered);
+    for (auto &rank : ranks)
+      rank.join();
+
+    ok = ok && std::count(done.begin(), done.end(), true) == parts && matches(snapshot, source, gathered);
+  }
+
+  // ranks as processes, each loading only its own shard
+  auto prefix = (std::filesystem::temp_directory_path() / ("distributed_test." + std::to_string(getpid()) + ".")).string();
+  auto paths = tinygraph::save_shards(snapshot, greedy, parts, prefix);
+  std::vector<Result> gathered;
+  auto status = tinygraph::spawn_ranks(parts, [&](tinygraph::Transport &transport) {
+    auto shard = tinygraph::load_shard(paths[transport.rank()]);
+    return run_rank(shard, transport, source, gathered) ? 0 : 1;
+  });
+  ok = ok && status == 0 && matches(snapshot, source, gathered);
+
+  // the files hold exactly what make_shards builds
+  auto shards = tinygraph::make_shards(snapshot, greedy, parts);
+  for (std::size_t r = 0; r < parts; r++) {
+    auto loaded = tinygraph::load_shard(paths[r]);
+    ok = ok && loaded.rank == r && loaded.owned == shards[r].owned && loaded.global_size == snapshot.size();
+    ok = ok && loaded.names == shards[r].names && loaded.global == shards[r].global && loaded.owner == shards[r].owner;
+    ok = ok && loaded.offsets == shards[r].offsets && loaded.targets == shards[r].targets && loaded.weights == shards[r].weights;
+    ok = ok && loaded.local == shards[r].local && loaded.size() < snapshot.size();
+  }
+
+  std::ostringstream saved;
+  shards[1].save(saved);
+  std::istringstream truncated(saved.str().substr(0, saved.str().size() / 2));
+  try {
+    tinygraph::Shard::load(truncated);
+    ok = false;
+  } catch (const std::runtime_error &) {
+  }
+
+  // a corrupt edge count runs into the end of the input instead of allocating it
+  tinygraph::Shard tiny;
+  tiny.owned = tiny.global_size = 1;
+  tiny.names = {"a"};
+  tiny.global = {0};
+  tiny.owner = {0};
+  tiny.offsets = {0, std::size_t(1) << 40};
+  std::ostringstream corrupt;
+  tiny.save(corrupt);
+  std::uint64_t edges = tiny.offsets.back();
+  auto bytes = corrupt.str();
+  bytes = bytes.substr(0, bytes.size() - 2 * sizeof(std::uint64_t)) + std::string(reinterpret_cast<const char *>(&edges), sizeof(edges));
+  std::istringstream huge(bytes);
+  try {
+    tinygraph::Shard::load(huge);
+    ok = false;
+  } catch (const std::runtime_error &) {
+  }
+
+  // a ghost that claims to be owned by the loading rank is rejected
+  tinygraph::Shard mislabelled;
+  mislabelled.owned = 1;
+  mislabelled.global_size = 2;
+  mislabelled.names = {"a", "b"};
+  mislabelled.global = {0, 1};
+  mislabelled.owner = {0, 0};
+  mislabelled.offsets = {0, 1};
+  mislabelled.targets = {1};
+  std::ostringstream ghost;
+  mislabelled.save(ghost);
+  std::istringstream ghost_bytes(ghost.str());
+  try {
+    tinygraph::Shard::load(ghost_bytes);
+    ok = false;
+  } catch (const std::runtime_error &) {
+  }
+
+  // an owner past the transport's ranks is refused before anything is sent to it
+  mislabelled.owner = {0, 5};
+  auto single = tinygraph::LocalTransport::group(1);
+  try {
+    tinygraph::distributed_bfs(mislabelled, *single[0], 0);
+    ok = false;
+  } catch (const std::invalid_argument &) {
+  }
+
+  for (auto &path : paths)
+    std::filesystem::remove(path);
+
+  // a negative cycle across shards is found by every rank
+  (*g->link(name_of(11, 19), name_of(0, 0), false))[DISTANCE] = -1000;
+  tinygraph::Snapshot cyclic(*g, DISTANCE);
+  auto cyclic_shards = tinygraph::make_shards(cyclic, tinygraph::partition(cyclic, parts, tinygraph::PartitionStrategy::greedy), parts);
+  status = tinygraph::spawn_ranks(parts, [&](tinygraph::Transport &transport) {
+    tinygraph::ShortestPaths paths;
+    return tinygraph::distributed_shortest_paths(cyclic_shards[transport.rank()], transport, source, paths) ? 1 : 0;
+  });
+  ok = ok && status == 0;
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return partitioned_grid_example() ? 0 : 1;
+}
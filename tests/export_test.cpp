@@ -0,0 +1,115 @@
+#include "../tinygraph.h"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+static constexpr char DISTANCE[] = "distance";
+
+std::unique_ptr<tinygraph::Graph> cities() {
+  auto city = tinygraph::typestore_add("city");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  g->add("BER", city)->add_prop("name", std::string("Berlin"));
+  g->add("VIE", city)->add_prop("population", 1900000);
+  g->add("NYC", city)->add_prop("area", 783.8);
+
+  (*g->link("BER", "VIE", true))[DISTANCE] = 681.5;
+  (*g->link("VIE", "NYC", false))[DISTANCE] = 6800;
+  (*g->link("NYC", "BER", false))["note"] = std::string("say \"hi\"");
+  return g;
+}
+
+std::string exported(const tinygraph::Graph &g, tinygraph::ExportFormat format, bool parallel = false, std::size_t chunk = 1 << 16,
+                     tinygraph::ThreadPool &pool = tinygraph::default_pool()) {
+  tinygraph::ExportOptions options;
+  options.format = format;
+  options.parallel = parallel;
+  options.chunk_bytes = chunk;
+
+  std::ostringstream out;
+  tinygraph::export_graph(g, out, options, pool);
+  return out.str();
+}
+
+bool formats_example() {
+  auto g = cities();
+
+  bool ok = g->str() == "BER [name = Berlin]\n"
+                        "\tBER -> VIE [distance = 681.5]\n"
+                        "NYC [area = 783.8]\n"
+                        "\tNYC -> BER [note = say \"hi\"]\n"
+                        "VIE [population = 1900000]\n"
+                        "\tVIE -> BER [distance = 681.5]\n"
+                        "\tVIE -> NYC [distance = 6800]\n";
+
+  auto dot = exported(*g, tinygraph::ExportFormat::dot);
+  ok = ok && dot.rfind("digraph {\n  \"BER\" [\"name\"=\"Berlin\"];\n", 0) == 0;
+  ok = ok && dot.find("  \"NYC\" -> \"BER\" [\"note\"=\"say \\\"hi\\\"\"];\n") != std::string::npos;
+  ok = ok && dot.size() >= 2 && dot.compare(dot.size() - 2, 2, "}\n") == 0;
+
+  auto jsonl = exported(*g, tinygraph::ExportFormat::jsonl);
+  ok = ok && jsonl.find("{\"vertex\":\"NYC\",\"type\":\"city\",\"properties\":{\"area\":783.8}}\n") != std::string::npos;
+  ok = ok && jsonl.find("{\"from\":\"VIE\",\"to\":\"NYC\",\"properties\":{\"distance\":6800}}\n") != std::string::npos;
+
+  tinygraph::ExportOptions options;
+  options.format = tinygraph::ExportFormat::edge_list;
+  options.weight_property = DISTANCE;
+  std::ostringstream list;
+  try {
+    tinygraph::export_graph(*g, list, options);
+    ok = false;
+  } catch (const std::invalid_argument &) {
+  }
+  ok = ok && exported(*g, tinygraph::ExportFormat::edge_list) == "BER VIE\nNYC BER\nVIE BER\nVIE NYC\n";
+
+  std::cout << "formats example" << std::endl;
+  std::cout << jsonl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool streaming_example() {
+  auto node = tinygraph::typestore_add("node");
+  tinygraph::Graph g;
+  for (std::size_t v = 0; v < 5000; v++)
+    g.add("v" + std::to_string(v), node)->add_prop("rank", 0.5 * v);
+  for (std::size_t v = 0; v < 5000; v++)
+    (*g.link("v" + std::to_string(v), "v" + std::to_string(v * 7 % 5000), false))[DISTANCE] = int(v % 13);
+
+  // a pool of its own, so that the batches run in parallel even on a single core
+  tinygraph::ThreadPool pool(3);
+  bool ok = true;
+  for (auto format : {tinygraph::ExportFormat::text, tinygraph::ExportFormat::dot, tinygraph::ExportFormat::jsonl}) {
+    auto whole = exported(g, format);
+    ok = ok && exported(g, format, true, 4096, pool) == whole && exported(g, format, false, 1) == whole;
+  }
+
+  // the descriptor writer produces the same bytes as the stream writer
+  tinygraph::ExportOptions options;
+  options.format = tinygraph::ExportFormat::edge_list;
+  options.weight_property = DISTANCE;
+  options.parallel = true;
+  std::ostringstream expected;
+  tinygraph::export_graph(g, expected, options);
+
+  auto file = std::tmpfile();
+  tinygraph::export_graph(g, fileno(file), options, pool);
+  std::string written(expected.str().size() + 1, '\0');
+  std::rewind(file);
+  written.resize(std::fread(&written[0], 1, written.size(), file));
+  std::fclose(file);
+  ok = ok && written == expected.str();
+
+  std::cout << "streaming example" << std::endl;
+  std::cout << "\t" << written.size() << " bytes of edge list" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = formats_example();
+  ok = streaming_example() && ok;
+  return ok ? 0 : 1;
+}
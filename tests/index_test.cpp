@@ -0,0 +1,116 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+static constexpr char LANGUAGE[] = "language_spoken";
+static constexpr char POPULATION[] = "population";
+
+std::vector<std::string> names(const std::vector<std::shared_ptr<tinygraph::Vertex>> &vertices) {
+  std::vector<std::string> res;
+  for (auto &vertex : vertices) {
+    res.push_back(vertex->name);
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+bool city_example() {
+  auto city = tinygraph::typestore_add("city");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  auto vienna = g->add("Vienna", city);
+  auto berlin = g->add("Berlin", city);
+  auto paris = g->add("Paris", city);
+
+  vienna->add_prop(LANGUAGE, "german");
+  berlin->add_prop(LANGUAGE, std::string("german"));
+  paris->add_prop(LANGUAGE, "french");
+
+  vienna->properties[POPULATION] = 1900000;
+  berlin->properties[POPULATION] = 3600000;
+  paris->properties[POPULATION] = 2100000.0;
+
+  g->create_index(LANGUAGE, tinygraph::IndexKind::hash);
+  g->create_index(POPULATION, tinygraph::IndexKind::sorted);
+
+  using list = std::vector<std::string>;
+
+  bool ok = names(g->find(LANGUAGE, "german")) == list{"Berlin", "Vienna"};
+  ok = ok && names(g->find_range(POPULATION, 2000000, 4000000)) == list{"Berlin", "Paris"};
+  ok = ok && names(g->find(POPULATION, 2100000)) == list{"Paris"};
+
+  // writes after the index exists, through every write path
+  paris->properties[LANGUAGE] = "german";
+  berlin->add_prop(POPULATION, 1000);
+  auto graz = g->add("Graz", city);
+  graz->add_prop(LANGUAGE, "german");
+  vienna->properties.erase(LANGUAGE);
+
+  ok = ok && names(g->find(LANGUAGE, "german")) == list{"Berlin", "Graz", "Paris"};
+  ok = ok && names(g->find_range(POPULATION, 2000000, 4000000)) == list{"Paris"};
+  ok = ok && names(g->find(LANGUAGE, "french")).empty();
+
+  // replacing a vertex drops the old one from the index
+  auto other_paris = tinygraph::vertex_create("Paris", city);
+  other_paris->add_prop(LANGUAGE, "french");
+  g->add_vertex(other_paris);
+  paris->add_prop(LANGUAGE, "german");
+
+  ok = ok && names(g->find(LANGUAGE, "german")) == list{"Berlin", "Graz"};
+  ok = ok && names(g->find(LANGUAGE, "french")) == list{"Paris"};
+
+  // without an index the same lookups scan
+  g->drop_index(LANGUAGE);
+  ok = ok && names(g->find(LANGUAGE, "german")) == list{"Berlin", "Graz"};
+
+  std::cout << "city example" << std::endl;
+  for (auto &name : names(g->find_range(POPULATION, 0, 1e9))) {
+    std::cout << "\t" << name << std::endl;
+  }
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool shared_vertex_example() {
+  using list = std::vector<std::string>;
+  auto city = tinygraph::typestore_add("city");
+  tinygraph::Graph europe, capitals;
+  europe.create_index(LANGUAGE, tinygraph::IndexKind::hash);
+  capitals.create_index(LANGUAGE, tinygraph::IndexKind::sorted);
+
+  // one vertex in two graphs keeps both indexes current
+  auto vienna = europe.add("Vienna", city);
+  capitals.add_vertex(vienna);
+  vienna->properties.insert({LANGUAGE, std::string("german")});
+  bool ok = names(europe.find(LANGUAGE, "german")) == list{"Vienna"} && names(capitals.find(LANGUAGE, "german")) == list{"Vienna"};
+
+  vienna->properties[LANGUAGE] = std::string("viennese");
+  ok = ok && europe.find(LANGUAGE, "german").empty() && names(capitals.find(LANGUAGE, "viennese")) == list{"Vienna"};
+
+  // leaving one graph leaves the other's index alone
+  europe.remove_vertex("Vienna");
+  vienna->properties[LANGUAGE] = std::string("german");
+  ok = ok && europe.find(LANGUAGE, "german").empty() && names(capitals.find(LANGUAGE, "german")) == list{"Vienna"};
+
+  // map semantics: insert keeps an existing value, reading a missing key adds an empty one
+  ok = ok && !vienna->properties.insert({LANGUAGE, std::string("french")}).second;
+  ok = ok && !vienna->properties["mayor"].has_value() && vienna->properties.count("mayor") == 1;
+
+  // a copy carries the properties but is in no graph's index
+  tinygraph::Vertex copy(*vienna);
+  copy.properties[LANGUAGE] = std::string("french");
+  ok = ok && capitals.find(LANGUAGE, "french").empty() && std::any_cast<std::string>(vienna->properties.at(LANGUAGE)) == "german";
+
+  std::cout << "shared vertex example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = city_example();
+  ok = shared_vertex_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+std::unique_ptr<tinygraph::Graph> grid(std::size_t side) {
+  auto junction = tinygraph::typestore_add("junction");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  auto name = [](std::size_t x, std::size_t y) { return "j" + std::to_string(10 + x) + std::to_string(10 + y); };
+  for (std::size_t x = 0; x < side; x++)
+    for (std::size_t y = 0; y < side; y++)
+      g->add(name(x, y), junction);
+
+  // a directed grid with a few diagonals; the weights repeat, so many paths tie
+  for (std::size_t x = 0; x < side; x++) {
+    for (std::size_t y = 0; y < side; y++) {
+      if (x + 1 < side)
+        (*g->link(name(x, y), name(x + 1, y), false))[DISTANCE] = int((x * 3 + y) % 4) + 1;
+      if (y + 1 < side)
+        (*g->link(name(x, y), name(x, y + 1), false))[DISTANCE] = int((x + y * 5) % 3) + 1;
+      if (x + 1 < side && y + 1 < side && (x + y) % 3 == 0)
+        (*g->link(name(x, y), name(x + 1, y + 1), false))[DISTANCE] = 3;
+      if (x > 0 && (x * y) % 4 == 1)
+        (*g->link(name(x, y), name(x - 1, y), false))[DISTANCE] = 2;
+    }
+  }
+  return g;
+}
+
+// Lengths of every simple path from source to target, by exhaustive search.
+void enumerate(const tinygraph::Snapshot &snapshot, std::size_t v, std::size_t target, double length, std::vector<bool> &on_path,
+               std::vector<double> &lengths) {
+  if (v == target) {
+    lengths.push_back(length);
+    return;
+  }
+  on_path[v] = true;
+  for (auto arc : snapshot.neighbours(v))
+    if (!on_path[arc.to])
+      enumerate(snapshot, arc.to, target, length + arc.weight, on_path, lengths);
+  on_path[v] = false;
+}
+
+bool valid(const tinygraph::Snapshot &snapshot, const tinygraph::WeightedPath &path, std::size_t source, std::size_t target) {
+  auto sorted = path.vertices;
+  std::sort(sorted.begin(), sorted.end());
+  if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    return false;
+
+  double length = 0;
+  for (std::size_t i = 0; i + 1 < path.vertices.size(); i++) {
+    double best = std::numeric_limits<double>::infinity();
+    for (auto arc : snapshot.neighbours(path.vertices[i]))
+      if (arc.to == path.vertices[i + 1])
+        best = std::min(best, arc.weight);
+    length += best;
+  }
+  return path.vertices.front() == source && path.vertices.back() == target && length == path.length;
+}
+
+bool brute_force_example() {
+  auto g = grid(5);
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  auto source = snapshot.id("j1010"), target = snapshot.id("j1414");
+
+  std::vector<double> lengths;
+  std::vector<bool> on_path(snapshot.size());
+  enumerate(snapshot, source, target, 0, on_path, lengths);
+  std::sort(lengths.begin(), lengths.end());
+
+  tinygraph::ThreadPool pool(3);
+  auto paths = tinygraph::k_shortest_paths(snapshot, source, target, 150, pool);
+
+  bool ok = paths.size() == std::min<std::size_t>(150, lengths.size());
+  for (std::size_t i = 0; ok && i < paths.size(); i++) {
+    ok = valid(snapshot, paths[i], source, target) && paths[i].length == lengths[i];
+    for (std::size_t j = 0; ok && j < i; j++)
+      ok = paths[j].vertices != paths[i].vertices;
+  }
+
+  // asking for more paths than exist returns all of them
+  auto all = tinygraph::k_shortest_paths(snapshot, snapshot.id("j1313"), target, 1000);
+
+  std::cout << "brute force example" << std::endl;
+  std::cout << "\t" << lengths.size() << " simple paths, shortest " << paths.front().length << ", 150th " << paths.back().length << std::endl;
+  ok = ok && all.size() < 1000;
+  for (auto &path : all)
+    ok = ok && valid(snapshot, path, snapshot.id("j1313"), target);
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool graph_example() {
+  auto city = tinygraph::typestore_add("city");
+  tinygraph::Graph g;
+  for (auto name : {"VIE", "BER", "NYC", "LAX", "ROM"})
+    g.add(name, city);
+  (*g.link("VIE", "BER", false))[DISTANCE] = 5;
+  (*g.link("VIE", "ROM", false))[DISTANCE] = 7;
+  (*g.link("BER", "NYC", false))[DISTANCE] = 60;
+  (*g.link("ROM", "NYC", false))[DISTANCE] = 65;
+  (*g.link("BER", "ROM", false))[DISTANCE] = 1;
+  (*g.link("NYC", "LAX", false))[DISTANCE] = 40;
+
+  auto paths = tinygraph::k_shortest_paths(g, "VIE", "LAX", DISTANCE, 5);
+  bool ok = paths.size() == 3;
+  ok = ok && paths[0].length == 105 && paths[0].vertices == std::vector<std::string>{"VIE", "BER", "NYC", "LAX"};
+  ok = ok && paths[1].length == 111 && paths[1].vertices == std::vector<std::string>{"VIE", "BER", "ROM", "NYC", "LAX"};
+  ok = ok && paths[2].length == 112 && paths[2].vertices == std::vector<std::string>{"VIE", "ROM", "NYC", "LAX"};
+  ok = ok && tinygraph::k_shortest_paths(g, "LAX", "VIE", DISTANCE, 5).empty();
+
+  std::cout << "graph example" << std::endl;
+  for (auto &path : paths) {
+    std::cout << "\t" << path.length << ":";
+    for (auto &v : path.vertices)
+      std::cout << " " << v;
+    std::cout << std::endl;
+  }
+
+  (*g.link("LAX", "VIE", false))[DISTANCE] = -1;
+  try {
+    tinygraph::k_shortest_paths(g, "VIE", "LAX", DISTANCE, 5);
+    ok = false;
+  } catch (const std::invalid_argument &) {
+  }
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = brute_force_example();
+  ok = graph_example() && ok;
+  return ok ? 0 : 1;
+}
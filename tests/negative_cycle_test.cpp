@@ -0,0 +1,183 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+std::string fiat(std::size_t i) { return "F" + std::to_string(100 + i); }
+
+std::string coin(std::size_t i) { return "C" + std::to_string(100 + i); }
+
+// Exchange quotes as -log(rate) in units of 1e-4, which turns arbitrage into a
+// negative cycle. Every rate is one price over another less a fee, so quotes between
+// cheap and dear currencies are negative but every round trip loses the fees. Money
+// flows from fiat into coins and never back.
+int log_price(std::size_t i) { return int(std::lround(1e4 * std::log(1 + double((i * 37) % 100) / 10))); }
+
+void quote(tinygraph::Graph &g, const std::string &from, int from_price, const std::string &to, int to_price) {
+  (*g.link(from, to, false))[DISTANCE] = from_price - to_price + 15;
+}
+
+std::unique_ptr<tinygraph::Graph> exchange(std::size_t fiats, std::size_t coins) {
+  auto currency = tinygraph::typestore_add("currency");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (std::size_t i = 0; i < fiats; i++)
+    g->add(fiat(i), currency);
+  for (std::size_t i = 0; i < coins; i++)
+    g->add(coin(i), currency);
+
+  for (std::size_t i = 0; i < fiats; i++) {
+    quote(*g, fiat(i), log_price(i), fiat((i + 1) % fiats), log_price((i + 1) % fiats));
+    quote(*g, fiat(i), log_price(i), fiat((i * 7 + 3) % fiats), log_price((i * 7 + 3) % fiats));
+    if (i % 4 == 0)
+      quote(*g, fiat(i), log_price(i), coin(i % coins), log_price(fiats + i % coins));
+  }
+  for (std::size_t i = 0; i < coins; i++) {
+    quote(*g, coin(i), log_price(fiats + i), coin((i + 1) % coins), log_price(fiats + (i + 1) % coins));
+    quote(*g, coin(i), log_price(fiats + i), coin((i * 5 + 2) % coins), log_price(fiats + (i * 5 + 2) % coins));
+  }
+  return g;
+}
+
+bool is_cycle(const tinygraph::Snapshot &snapshot, const tinygraph::NegativeCycle &cycle) {
+  if (cycle.vertices.empty())
+    return false;
+
+  double weight = 0;
+  for (std::size_t i = 0; i < cycle.vertices.size(); i++) {
+    auto from = cycle.vertices[i], to = cycle.vertices[(i + 1) % cycle.vertices.size()];
+    double best = std::numeric_limits<double>::infinity();
+    for (auto arc : snapshot.neighbours(from))
+      if (arc.to == to)
+        best = std::min(best, arc.weight);
+    weight += best;
+  }
+  return weight <= cycle.weight && cycle.weight < 0;
+}
+
+bool settled_example() {
+  auto g = exchange(120, 80);
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+
+  auto negative = std::count_if(snapshot.weights.begin(), snapshot.weights.end(), [](double w) { return w < 0; });
+  bool ok = negative > 0;
+
+  for (std::size_t source = 0; source < snapshot.size(); source += 17) {
+    tinygraph::ShortestPaths expected, paths;
+    tinygraph::NegativeCycle cycle;
+    ok = ok && tinygraph::bellman_ford(snapshot, source, expected);
+    ok = ok && !tinygraph::find_negative_cycle(snapshot, source, paths, cycle) && cycle.vertices.empty();
+    ok = ok && paths.distance == expected.distance;
+    for (std::size_t v = 0; ok && v < snapshot.size(); v++)
+      ok = paths.distance[v] == std::numeric_limits<double>::infinity() || tinygraph::path_to(paths, v).front() == source;
+  }
+
+  std::cout << "settled example" << std::endl;
+  std::cout << "\t" << negative << " of " << snapshot.targets.size() << " quotes negative" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool arbitrage_example() {
+  const std::size_t fiats = 120, coins = 80;
+  auto g = exchange(fiats, coins);
+  tinygraph::Snapshot fair(*g, DISTANCE);
+  auto source = fair.id(fiat(0));
+
+  tinygraph::ShortestPaths before;
+  bool ok = tinygraph::bellman_ford(fair, source, before);
+
+  // one far too generous quote between two coins
+  (*g->link(coin(30), coin(31), false))[DISTANCE] = log_price(fiats + 30) - log_price(fiats + 31) - 10000;
+  tinygraph::Snapshot planted(*g, DISTANCE);
+
+  tinygraph::ShortestPaths paths;
+  tinygraph::NegativeCycle cycle;
+  ok = ok && tinygraph::find_negative_cycle(planted, source, paths, cycle) && is_cycle(planted, cycle);
+
+  // the cycle goes through the planted quote
+  bool through = false;
+  for (std::size_t i = 0; i < cycle.vertices.size(); i++) {
+    auto from = planted.names[cycle.vertices[i]], to = planted.names[cycle.vertices[(i + 1) % cycle.vertices.size()]];
+    through = through || (from == coin(30) && to == coin(31));
+  }
+  ok = ok && through;
+
+  // fiat cannot be reached from the coins and keeps its prices; every coin can be
+  // reached from the cycle and has none
+  const auto minus_infinity = -std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < fiats; i++) {
+    auto v = planted.id(fiat(i));
+    ok = ok && paths.distance[v] == before.distance[fair.id(fiat(i))];
+  }
+  for (std::size_t i = 0; i < coins; i++)
+    ok = ok && paths.distance[planted.id(coin(i))] == minus_infinity;
+
+  // and it is found without a source too
+  tinygraph::ShortestPaths anywhere;
+  tinygraph::NegativeCycle found;
+  ok = ok && tinygraph::find_negative_cycle(planted, tinygraph::unreachable, anywhere, found, false) && is_cycle(planted, found);
+
+  std::cout << "arbitrage example" << std::endl;
+  std::cout << "\tcycle of " << cycle.vertices.size() << " with weight " << cycle.weight << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool unaffected_example() {
+  auto node = tinygraph::typestore_add("node");
+  tinygraph::Graph g;
+  for (auto name : {"S", "X", "Y", "A", "B", "C", "Z"})
+    g.add(name, node);
+  (*g.link("S", "X", false))[DISTANCE] = 1;
+  (*g.link("X", "Y", false))[DISTANCE] = 2;
+  (*g.link("S", "A", false))[DISTANCE] = 4;
+  (*g.link("A", "B", false))[DISTANCE] = 2;
+  (*g.link("B", "C", false))[DISTANCE] = -3;
+  (*g.link("C", "A", false))[DISTANCE] = -1;
+  (*g.link("C", "Z", false))[DISTANCE] = 1;
+  (*g.link("Z", "Y", false))[DISTANCE] = 1;
+
+  tinygraph::Snapshot snapshot(g, DISTANCE);
+  tinygraph::ShortestPaths paths;
+  tinygraph::NegativeCycle cycle;
+  bool ok = tinygraph::find_negative_cycle(snapshot, snapshot.id("S"), paths, cycle);
+  ok = ok && cycle.weight == -2 && cycle.vertices.size() == 3 && is_cycle(snapshot, cycle);
+
+  // S and X keep their distances; the cycle and everything after it has none
+  const auto minus_infinity = -std::numeric_limits<double>::infinity();
+  ok = ok && paths.distance[snapshot.id("S")] == 0 && paths.distance[snapshot.id("X")] == 1;
+  ok = ok && paths.parent[snapshot.id("X")] == snapshot.id("S");
+  for (auto name : {"A", "B", "C", "Z", "Y"})
+    ok = ok && paths.distance[snapshot.id(name)] == minus_infinity;
+
+  std::vector<std::string> names;
+  double weight = 0;
+  ok = ok && tinygraph::find_negative_cycle(g, DISTANCE, names, weight) && weight == -2 && names.size() == 3;
+  ok = ok && g.negative_cycle == tinygraph::Graph::negative;
+
+  std::cout << "unaffected example" << std::endl;
+  std::cout << "\t";
+  for (auto &name : names)
+    std::cout << name << " -> ";
+  std::cout << names.front() << " = " << weight << std::endl;
+
+  g.remove_edge("C", "A");
+  (*g.link("C", "A", false))[DISTANCE] = 5;
+  ok = ok && !tinygraph::find_negative_cycle(g, DISTANCE, names, weight) && names.empty();
+  ok = ok && g.negative_cycle == tinygraph::Graph::non_negative;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = settled_example();
+  ok = arbitrage_example() && ok;
+  ok = unaffected_example() && ok;
+  return ok ? 0 : 1;
+}
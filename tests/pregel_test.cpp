@@ -0,0 +1,102 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+std::unique_ptr<tinygraph::Graph> airports(const std::vector<std::tuple<std::string, std::string, int>> &links) {
+  auto airport = tinygraph::typestore_add("airport");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto &[from, to, distance] : links) {
+    if (!g->vertex_exists(from))
+      g->add(from, airport);
+    if (!g->vertex_exists(to))
+      g->add(to, airport);
+    (*g->link(from, to, false))[DISTANCE] = distance;
+  }
+  return g;
+}
+
+bool shortest_paths_example() {
+  auto g = airports({{"VIE", "BER", 522}, {"BER", "PAR", 878}, {"VIE", "PAR", 1500}, {"PAR", "LON", 344},
+                     {"LON", "NYC", 5570}, {"BER", "NYC", 6385}, {"NYC", "LAX", 3983}, {"MEX", "LAX", 2499}});
+
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  tinygraph::ShortestPaths paths;
+  bool ok = tinygraph::pregel_bellman_ford(snapshot, snapshot.id("VIE"), paths);
+  ok = ok && g->bellman_ford("VIE", DISTANCE);
+
+  std::cout << "shortest paths example" << std::endl;
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    auto expected = std::get<int>(g->distances[snapshot.names[v]]);
+    auto found = paths.distance[v];
+    ok = ok && (expected == std::numeric_limits<int>::max() ? found == std::numeric_limits<double>::infinity() : found == expected);
+    std::cout << "\t" << snapshot.names[v] << " : " << found << std::endl;
+  }
+  auto route = tinygraph::path_to(paths, snapshot.id("LAX"));
+  ok = ok && route.size() == 4 && snapshot.names[route[2]] == "NYC";
+
+  // a reachable negative cycle never settles
+  auto cycle = airports({{"A", "B", 1}, {"B", "C", -3}, {"C", "A", 1}, {"C", "D", 2}});
+  tinygraph::Snapshot cyclic(*cycle, DISTANCE);
+  ok = ok && !tinygraph::pregel_bellman_ford(cyclic, cyclic.id("A"), paths);
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+// connected components by label propagation: every vertex takes the smallest label
+// it hears of; an aggregator counts the changes per superstep
+bool label_propagation_example() {
+  auto g = airports({{"VIE", "BER", 1}, {"BER", "PAR", 1}, {"PAR", "VIE", 1}, {"NYC", "LAX", 1}, {"LAX", "MEX", 1}});
+  for (auto &[from, to] : std::vector<std::pair<std::string, std::string>>{{"BER", "VIE"}, {"PAR", "BER"}, {"VIE", "PAR"}, {"LAX", "NYC"}, {"MEX", "LAX"}})
+    (*g->link(from, to, false))[DISTANCE] = 1;
+  g->add("SYD", tinygraph::typestore_get("airport"));
+
+  tinygraph::Snapshot snapshot(*g);
+  tinygraph::Pregel<std::size_t, std::size_t, tinygraph::Snapshot> engine(snapshot, 0, 3);
+  engine.combine_with([](std::size_t a, std::size_t b) { return std::min(a, b); });
+  auto changes = engine.add_aggregator(0, [](double a, double b) { return a + b; });
+
+  std::vector<double> changed;
+  auto steps = engine.run([&](auto &vertex, const std::vector<std::size_t> &messages) {
+    bool improved = vertex.superstep() == 0;
+    if (improved)
+      vertex.value() = vertex.id();
+    if (vertex.id() == 0 && vertex.superstep() > 0)
+      changed.push_back(vertex.aggregated(changes));
+
+    for (auto label : messages) {
+      if (label < vertex.value()) {
+        vertex.value() = label;
+        improved = true;
+      }
+    }
+    if (improved) {
+      vertex.aggregate(changes, 1);
+      for (auto arc : vertex.neighbours())
+        vertex.send(arc.to, vertex.value());
+    }
+    vertex.vote_to_halt();
+  });
+
+  auto label = [&](const std::string &name) { return engine.values[snapshot.id(name)]; };
+  bool ok = label("VIE") == label("BER") && label("BER") == label("PAR") && label("NYC") == label("MEX");
+  ok = ok && label("VIE") != label("NYC") && label("SYD") == snapshot.id("SYD");
+  ok = ok && steps == 3 && !changed.empty() && changed[0] == snapshot.size();
+
+  std::cout << "label propagation example" << std::endl;
+  for (std::size_t v = 0; v < snapshot.size(); v++)
+    std::cout << "\t" << snapshot.names[v] << " : " << snapshot.names[engine.values[v]] << std::endl;
+  std::cout << "\t" << steps << " supersteps" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = shortest_paths_example();
+  ok = label_propagation_example() && ok;
+  return ok ? 0 : 1;
+}
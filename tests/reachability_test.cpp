@@ -0,0 +1,132 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+std::unique_ptr<tinygraph::Graph> layered(std::size_t vertices) {
+  auto node = tinygraph::typestore_add("node");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (std::size_t v = 0; v < vertices; v++)
+    g->add("n" + std::to_string(1000 + v), node);
+
+  // mostly forward edges, so the condensation is a deep DAG, plus a few back edges
+  // that fold short stretches into cycles
+  for (std::size_t v = 0; v < vertices; v++) {
+    auto name = "n" + std::to_string(1000 + v);
+    for (std::size_t s = 1; s <= 2; s++) {
+      auto to = v + 1 + (v * 7 + s * 13) % 40;
+      if (to < vertices && (v * 11 + s) % 3 != 0)
+        g->link(name, "n" + std::to_string(1000 + to), false);
+    }
+    if (v % 50 == 0 && v >= 5)
+      g->link(name, "n" + std::to_string(1000 + v - 5), false);
+  }
+  return g;
+}
+
+bool agrees(const tinygraph::ReachabilityIndex &index, const tinygraph::Snapshot &snapshot, std::size_t &decided) {
+  decided = 0;
+  for (std::size_t from = 0; from < snapshot.size(); from++) {
+    auto level = tinygraph::bfs(snapshot, from);
+    for (std::size_t to = 0; to < snapshot.size(); to++) {
+      bool answer;
+      decided += index.try_labels(from, to, answer);
+      if (index.reachable(from, to) != (level[to] != tinygraph::unreachable))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool queries_example() {
+  auto g = layered(400);
+  tinygraph::Snapshot snapshot(*g);
+  tinygraph::ReachabilityIndex index(snapshot);
+
+  std::size_t decided;
+  bool ok = agrees(index, snapshot, decided);
+  auto pairs = snapshot.size() * snapshot.size();
+
+  std::cout << "queries: " << index.component_count() << " components, " << index.memory_bytes() << " bytes, "
+            << decided << "/" << pairs << " answered from labels";
+  ok = ok && index.component_count() < snapshot.size() && decided * 4 > pairs * 3;
+  ok = ok && index.reachable("n1000", "n1399") == (tinygraph::bfs(snapshot, 0)[399] != tinygraph::unreachable);
+  ok = ok && !index.reachable("n1000", "missing");
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool cycle_example() {
+  auto node = tinygraph::typestore_add("node");
+  tinygraph::Graph g;
+  for (auto name : {"a", "b", "c", "d", "e"})
+    g.add(name, node);
+  g.link("a", "b", false);
+  g.link("b", "c", false);
+  g.link("c", "a", false);
+  g.link("c", "d", false);
+
+  tinygraph::ReachabilityIndex index(g);
+  bool ok = index.component_count() == 3;
+  ok = ok && index.reachable("a", "c") && index.reachable("c", "b") && index.reachable("b", "d");
+  ok = ok && !index.reachable("d", "a") && !index.reachable("a", "e") && !index.reachable("e", "a");
+  ok = ok && index.reachable("e", "e");
+
+  std::cout << "cycle: " << index.component_count() << " components";
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool serialize_example() {
+  auto g = layered(300);
+  tinygraph::Snapshot snapshot(*g);
+  tinygraph::ReachabilityIndex index(snapshot, 4);
+
+  std::stringstream buffer;
+  index.save(buffer);
+  auto bytes = buffer.str();
+  auto loaded = tinygraph::ReachabilityIndex::load(buffer);
+
+  std::size_t decided;
+  bool ok = loaded.size() == index.size() && agrees(loaded, snapshot, decided);
+
+  // a truncated stream is rejected rather than producing a broken index
+  std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+  try {
+    tinygraph::ReachabilityIndex::load(truncated);
+    ok = false;
+  } catch (const std::runtime_error &) {
+  }
+
+  // so is a corrupt edge count: the last offset claims 2^40 targets and the stream
+  // ends right after saying so
+  std::size_t at = 4 + 4 + 8;
+  for (auto &name : snapshot.names)
+    at += 8 + name.size();
+  at += 8 + 8 + 8 + 4 * snapshot.size() + 8 + 8 * index.component_count();
+  std::uint64_t huge = std::uint64_t(1) << 40;
+  auto corrupt = bytes.substr(0, at);
+  corrupt.append(reinterpret_cast<const char *>(&huge), sizeof(huge));
+  corrupt.append(reinterpret_cast<const char *>(&huge), sizeof(huge));
+  std::stringstream oversized(corrupt);
+  try {
+    tinygraph::ReachabilityIndex::load(oversized);
+    ok = false;
+  } catch (const std::runtime_error &) {
+  }
+
+  std::cout << "serialize: " << bytes.size() << " bytes, built in " << index.build_seconds << "s";
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+
+  bool ok = queries_example();
+  ok = cycle_example() && ok;
+  ok = serialize_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+bool has_edge(tinygraph::Snapshot &snapshot, const std::string &from, const std::string &to) {
+  for (auto arc : snapshot.neighbours(snapshot.id(from))) {
+    if (snapshot.names[arc.to] == to)
+      return true;
+  }
+  return false;
+}
+
+bool rolling_window_example() {
+  auto airport = tinygraph::typestore_add("airport");
+  auto g = std::make_unique<tinygraph::Graph>();
+  g->compaction_threshold = 0.4;
+
+  for (auto name : {"VIE", "BER", "PAR", "LON", "ROM"})
+    g->add(name, airport)->add_prop("hub", 1);
+  g->create_index("hub", tinygraph::IndexKind::hash);
+
+  (*g->link("VIE", "BER", true))[DISTANCE] = 522;
+  (*g->link("BER", "PAR", true))[DISTANCE] = 878;
+  (*g->link("VIE", "PAR", true))[DISTANCE] = 1034;
+  (*g->link("PAR", "LON", false))[DISTANCE] = 344;
+  (*g->link("ROM", "VIE", false))[DISTANCE] = 765;
+  (*g->link("LON", "ROM", false))[DISTANCE] = 1434;
+
+  bool ok = g->stored_edges == 9;
+
+  // both halves of an undirected link go
+  ok = ok && g->remove_edge("VIE", "PAR") && !g->remove_edge("VIE", "PAR") && !g->remove_edge("PAR", "VIE");
+  ok = ok && g->dead_edges == 2 && g->vertices["PAR"]->connections.size() == 3;
+
+  g->bellman_ford("VIE", DISTANCE);
+  ok = ok && std::get<int>(g->distances["PAR"]) == 1400;
+
+  // edges into a removed vertex are skipped before any compaction, and LON -> ROM counts
+  // as dead right away
+  ok = ok && g->remove_vertex("ROM") && !g->remove_vertex("ROM");
+  ok = ok && g->dead_edges == 3 && g->stored_edges == 8;
+  ok = ok && !g->vertex_exists("ROM") && g->find("hub", 1).size() == 4 && g->vertices_of(airport).size() == 4;
+
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  ok = ok && snapshot.size() == 4 && !has_edge(snapshot, "VIE", "PAR") && has_edge(snapshot, "VIE", "BER");
+  ok = ok && tinygraph::strongly_connected_components(snapshot).count == 2;
+  ok = ok && g->str().find("ROM") == std::string::npos;
+
+  // a new vertex of the same name does not pick up the old edges
+  g->add("ROM", airport);
+  tinygraph::Snapshot again(*g, DISTANCE);
+  ok = ok && again.degree(again.id("LON")) == 0;
+
+  // passing the threshold compacts every connection list
+  ok = ok && g->remove_edge("VIE", "BER") && g->dead_edges == 0;
+  ok = ok && g->vertices["VIE"]->connections.empty() && g->vertices["LON"]->connections.empty();
+  ok = ok && g->stored_edges == 3 && g->vertices["PAR"]->connections.size() == 2;
+
+  std::cout << "rolling window example" << std::endl;
+  std::cout << g->str();
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool sweep_example() {
+  auto airport = tinygraph::typestore_add("airport");
+  auto g = std::make_unique<tinygraph::Graph>();
+  g->compaction_batch = 4;
+
+  // every spoke flies into the hub, twice
+  g->add("hub", airport);
+  for (int i = 0; i < 20; i++) {
+    auto name = "spoke" + std::to_string(i);
+    g->add(name, airport);
+    (*g->link(name, "hub", false))[DISTANCE] = i;
+    (*g->link(name, "hub", false))[DISTANCE] = i + 1;
+  }
+  (*g->link("hub", "spoke0", true))[DISTANCE] = 1;
+
+  bool ok = g->stored_edges == 42 && g->vertices["hub"]->in_edges == 41;
+
+  // both parallel edges go, the reverse link stays
+  ok = ok && g->remove_edge("spoke3", "hub") && !g->remove_edge("spoke3", "hub");
+  ok = ok && g->dead_edges == 2 && g->vertices["hub"]->in_edges == 39 && !g->compacting;
+  ok = ok && g->remove_edge("spoke0", "hub") && g->vertices["spoke0"]->in_edges == 0;
+  ok = ok && g->vertices["hub"]->in_edges == 36 && g->dead_edges == 6;
+
+  // the directed edges into the hub die with it, which starts a sweep; each step only
+  // gets through a few of the spokes
+  ok = ok && g->remove_vertex("hub");
+  ok = ok && g->compacting && g->dead_edges > 0 && g->vertices["spoke19"]->connections.size() == 2;
+
+  std::size_t steps = 0;
+  while (g->compacting && steps < 100) {
+    g->compact_step();
+    steps++;
+  }
+  ok = ok && !g->compacting && steps > 1 && g->dead_edges == 0 && g->stored_edges == 0;
+
+  for (const auto& [name, vertex] : g->vertices)
+    ok = ok && vertex->connections.empty() && vertex->edges_to.empty();
+
+  std::cout << "sweep example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool replace_example() {
+  auto airport = tinygraph::typestore_add("airport");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto name : {"VIE", "BER", "PAR"})
+    g->add(name, airport);
+  for (int i = 0; i < 3; i++)
+    (*g->link("VIE", "BER", false))[DISTANCE] = 522 + i;
+
+  // a vertex added under a taken name takes the old one's edges out of the count
+  g->add("VIE", airport);
+  bool ok = g->stored_edges == 0 && g->vertices_of(airport).size() == 3;
+
+  (*g->link("VIE", "BER", false))[DISTANCE] = 522;
+  (*g->link("VIE", "PAR", false))[DISTANCE] = 1034;
+  ok = ok && g->stored_edges == 2;
+
+  // a vertex put into `vertices` directly is not in vertices_of, and replacing it
+  // leaves the others there
+  g->vertices["ROM"] = tinygraph::vertex_create("ROM", airport);
+  g->add("ROM", airport);
+  ok = ok && g->vertices_of(airport).size() == 4 && g->stored_edges == 2;
+
+  // one dead edge of two passes the threshold, so the lists are compacted right away
+  ok = ok && g->remove_edge("VIE", "BER") && !g->compacting;
+  ok = ok && g->dead_edges == 0 && g->stored_edges == 1 && g->vertices["VIE"]->connections.size() == 1;
+
+  std::cout << "replace example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool fan_out_example() {
+  auto airport = tinygraph::typestore_add("airport");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  g->add("hub", airport);
+  for (int i = 0; i < 40; i++) {
+    auto name = "spoke" + std::to_string(i);
+    g->add(name, airport);
+    (*g->link("hub", name, false))[DISTANCE] = i;
+  }
+
+  // linking alone builds no edge index
+  auto hub = g->vertices["hub"];
+  bool ok = !hub->edges_indexed && hub->edges_to.empty();
+
+  // the first removal from a vertex of this degree indexes its edges, and later links
+  // are added to the index
+  ok = ok && g->remove_edge("hub", "spoke0") && hub->edges_indexed && hub->edges_to.size() == 40;
+  (*g->link("hub", "spoke0", false))[DISTANCE] = 0;
+  ok = ok && hub->edges_to.size() == 41 && g->remove_edge("hub", "spoke0") && !g->remove_edge("hub", "spoke0");
+  ok = ok && hub->in_edges == 0 && g->vertices["spoke0"]->in_edges == 0;
+
+  std::cout << "fan out example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = rolling_window_example();
+  ok = sweep_example() && ok;
+  ok = replace_example() && ok;
+  ok = fan_out_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+
+// Largest |id(a) - id(b)| over all edges; small bandwidth means neighbours sit close
+// together in the snapshot arrays.
+std::size_t bandwidth(const tinygraph::Snapshot &snapshot) {
+  std::size_t res = 0;
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    for (auto arc : snapshot.neighbours(v)) {
+      res = std::max(res, arc.to > v ? arc.to - v : v - arc.to);
+    }
+  }
+  return res;
+}
+
+std::set<std::pair<std::string, std::string>> edge_names(const tinygraph::Snapshot &snapshot) {
+  std::set<std::pair<std::string, std::string>> res;
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    for (auto arc : snapshot.neighbours(v)) {
+      res.insert({snapshot.names[v], snapshot.names[arc.to]});
+    }
+  }
+  return res;
+}
+
+bool grid_example() {
+  auto cell = tinygraph::typestore_add("cell");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  // A 30x30 grid whose names are shuffled, so name order says nothing about structure.
+  constexpr int side = 30;
+  std::vector<int> label(side * side);
+  for (int i = 0; i < side * side; i++)
+    label[i] = i;
+  std::shuffle(label.begin(), label.end(), std::mt19937(3));
+
+  auto name = [&label](int x, int y) { return std::to_string(label[y * side + x]); };
+
+  for (int i = 0; i < side * side; i++) {
+    g->add(std::to_string(i), cell);
+  }
+  for (int y = 0; y < side; y++) {
+    for (int x = 0; x < side; x++) {
+      if (x + 1 < side)
+        g->link(name(x, y), name(x + 1, y), true);
+      if (y + 1 < side)
+        g->link(name(x, y), name(x, y + 1), true);
+    }
+  }
+
+  tinygraph::Snapshot by_name(*g);
+  auto expected_edges = edge_names(by_name);
+  auto expected_levels = tinygraph::bfs(by_name, by_name.id(name(0, 0)));
+
+  bool ok = true;
+
+  std::cout << "grid example" << std::endl;
+  std::cout << "\tname bandwidth " << bandwidth(by_name) << std::endl;
+
+  for (auto [ordering, title] : {std::pair{tinygraph::Ordering::degree, "degree"},
+                                 std::pair{tinygraph::Ordering::rcm, "rcm"},
+                                 std::pair{tinygraph::Ordering::bfs, "bfs"}}) {
+    tinygraph::Snapshot snapshot(*g, "", ordering);
+
+    for (std::size_t v = 0; v < snapshot.size(); v++) {
+      ok = ok && snapshot.id(snapshot.names[v]) == v && snapshot.vertices[v]->name == snapshot.names[v];
+    }
+    ok = ok && edge_names(snapshot) == expected_edges;
+
+    auto levels = tinygraph::bfs(snapshot, snapshot.id(name(0, 0)));
+    for (std::size_t v = 0; v < snapshot.size(); v++) {
+      ok = ok && levels[v] == expected_levels[by_name.id(snapshot.names[v])];
+    }
+
+    std::cout << "\t" << title << " bandwidth " << bandwidth(snapshot) << std::endl;
+  }
+
+  tinygraph::Snapshot rcm(*g, "", tinygraph::Ordering::rcm);
+  ok = ok && bandwidth(rcm) <= 2 * side;
+
+  rcm.reorder(tinygraph::Ordering::name);
+  ok = ok && rcm.names == by_name.names && edge_names(rcm) == expected_edges;
+
+  // reordering by name a snapshot that already is sorts the arcs all the same
+  auto arcs_sorted = [](const tinygraph::Snapshot &snapshot) {
+    for (std::size_t v = 0; v < snapshot.size(); v++)
+      if (!std::is_sorted(snapshot.targets.begin() + snapshot.offsets[v], snapshot.targets.begin() + snapshot.offsets[v + 1]))
+        return false;
+    return true;
+  };
+  auto resorted = by_name;
+  resorted.reorder(tinygraph::Ordering::name);
+  ok = ok && !arcs_sorted(by_name) && arcs_sorted(resorted) && resorted.names == by_name.names && edge_names(resorted) == expected_edges;
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return grid_example() ? 0 : 1;
+}
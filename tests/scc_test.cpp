@@ -0,0 +1,112 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <set>
+
+using component_set = std::set<std::set<std::string>>;
+
+component_set canonical(const std::vector<std::vector<std::string>> &components) {
+  component_set res;
+  for (const auto &component : components) {
+    res.insert(std::set<std::string>(component.begin(), component.end()));
+  }
+  return res;
+}
+
+void print_components(const std::vector<std::vector<std::string>> &components) {
+  for (const auto &component : components) {
+    std::cout << "\t{ ";
+    for (const auto &vertex : component) {
+      std::cout << vertex << " ";
+    }
+    std::cout << "}" << std::endl;
+  }
+}
+
+bool dependency_example() {
+  auto module = tinygraph::typestore_add("module");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto name : {"app", "ui", "core", "io", "net", "log", "util"}) {
+    g->add(name, module);
+  }
+
+  bool directed = false;
+
+  g->link("app", "ui", directed);
+  g->link("ui", "core", directed);
+  g->link("core", "ui", directed);
+  g->link("core", "io", directed);
+  g->link("io", "net", directed);
+  g->link("net", "io", directed);
+  g->link("net", "log", directed);
+  g->link("log", "log", directed);
+  g->link("io", "util", directed);
+
+  auto tarjan = tinygraph::strongly_connected_components(*g);
+  auto fwbw = tinygraph::strongly_connected_components(*g, true);
+
+  std::cout << "dependency example" << std::endl;
+  print_components(tarjan);
+
+  component_set expected = {{"app"}, {"ui", "core"}, {"io", "net"}, {"log"}, {"util"}};
+  bool ok = canonical(tarjan) == expected && canonical(fwbw) == expected;
+
+  auto dag = tinygraph::condensation(*g, tarjan);
+  std::cout << dag->str();
+
+  // Tarjan emits sinks first, so every condensation edge points to a smaller id.
+  for (const auto &[name, vertex] : dag->vertices) {
+    for (const auto &edge : vertex->connections) {
+      ok = ok && std::stoul(edge->to->name) < std::stoul(name);
+    }
+  }
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool large_ring_example() {
+  auto node = tinygraph::typestore_add("node");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  // 40 rings of 250 vertices, chained together by one-way bridges, so the
+  // forward-backward pass has to peel them apart instead of leaving everything to Tarjan.
+  constexpr int rings = 40;
+  constexpr int ring_size = 250;
+
+  for (int r = 0; r < rings; r++) {
+    for (int i = 0; i < ring_size; i++) {
+      g->add(std::to_string(r) + "." + std::to_string(i), node);
+    }
+  }
+
+  for (int r = 0; r < rings; r++) {
+    for (int i = 0; i < ring_size; i++) {
+      g->link(std::to_string(r) + "." + std::to_string(i), std::to_string(r) + "." + std::to_string((i + 1) % ring_size), false);
+    }
+    if (r + 1 < rings) {
+      g->link(std::to_string(r) + ".0", std::to_string(r + 1) + ".7", false);
+    }
+  }
+
+  auto tarjan = tinygraph::strongly_connected_components(*g);
+  auto fwbw = tinygraph::strongly_connected_components(*g, true);
+
+  bool ok = tarjan.size() == rings && canonical(tarjan) == canonical(fwbw);
+
+  std::cout << "large ring example" << std::endl;
+  std::cout << "\t" << tarjan.size() << " components" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = dependency_example();
+  ok = large_ring_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+#include "../tinygraph.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+
+static constexpr char DISTANCE[] = "distance";
+
+bool network_example() {
+  auto city = tinygraph::typestore_add("city");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto name : {"VIE", "BER", "PAR", "ROM", "MAD"}) {
+    g->add(name, city);
+  }
+
+  bool undirected = true;
+
+  std::shared_ptr<std::map<std::string, std::any>> linkprops;
+
+  linkprops = g->link("VIE", "BER", undirected);
+  linkprops->insert({DISTANCE, 522});
+
+  linkprops = g->link("VIE", "ROM", undirected);
+  linkprops->insert({DISTANCE, 765});
+
+  linkprops = g->link("BER", "PAR", undirected);
+  linkprops->insert({DISTANCE, 878});
+
+  linkprops = g->link("VIE", "PAR", undirected);
+  linkprops->insert({DISTANCE, 1034});
+
+  linkprops = g->link("PAR", "MAD", undirected);
+  linkprops->insert({DISTANCE, 1054.5});
+
+  linkprops = g->link("ROM", "MAD", undirected);
+  linkprops->insert({DISTANCE, 1365});
+
+  auto forest = tinygraph::minimum_spanning_forest(*g, DISTANCE);
+
+  std::cout << "network example" << std::endl;
+  for (auto &edge : forest.edges) {
+    std::cout << "\t" << edge.from << " - " << edge.to << std::endl;
+  }
+
+  bool ok = forest.edges.size() == 4 && std::holds_alternative<double>(forest.total) &&
+            std::get<double>(forest.total) == 522 + 765 + 878 + 1054.5;
+
+  std::visit([](auto total) { std::cout << "\ttotal " << total << std::endl; }, forest.total);
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool large_example() {
+  auto node = tinygraph::typestore_add("node");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  // enough edges to take the Boruvka path, with two separate halves and many ties
+  constexpr int vertices = 20000;
+  std::mt19937 random(11);
+  std::uniform_int_distribution<int> half(0, vertices / 2 - 1);
+  std::uniform_int_distribution<int> weight(1, 50);
+
+  for (int i = 0; i < vertices; i++) {
+    g->add(std::to_string(i), node);
+  }
+
+  struct Link {
+    int from, to, weight;
+  };
+  std::vector<Link> links;
+  for (int i = 0; i < 40000; i++) {
+    int offset = (i % 2) * (vertices / 2);
+    links.push_back({half(random) + offset, half(random) + offset, weight(random)});
+    auto linkprops = g->link(std::to_string(links.back().from), std::to_string(links.back().to), true);
+    linkprops->insert({DISTANCE, links.back().weight});
+  }
+
+  std::sort(links.begin(), links.end(), [](const Link &a, const Link &b) { return a.weight < b.weight; });
+  std::vector<int> parent(vertices);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](int v) {
+    while (parent[v] != v)
+      v = parent[v] = parent[parent[v]];
+    return v;
+  };
+
+  long expected = 0;
+  std::size_t expected_edges = 0;
+  for (auto &link : links) {
+    int a = find(link.from), b = find(link.to);
+    if (a == b)
+      continue;
+    parent[a] = b;
+    expected += link.weight;
+    expected_edges++;
+  }
+
+  auto forest = tinygraph::minimum_spanning_forest(*g, DISTANCE);
+
+  bool ok = forest.edges.size() == expected_edges && std::holds_alternative<int>(forest.total) &&
+            std::get<int>(forest.total) == expected;
+
+  // the parallel rounds on a pool of their own pick exactly the edges Kruskal picks
+  // with ties broken by edge index
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  std::vector<std::size_t> order(snapshot.targets.size()), kruskal;
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&snapshot](std::size_t a, std::size_t b) {
+    return snapshot.weights[a] != snapshot.weights[b] ? snapshot.weights[a] < snapshot.weights[b] : a < b;
+  });
+  std::vector<int> set(snapshot.size());
+  std::iota(set.begin(), set.end(), 0);
+  auto root = [&set](int v) {
+    while (set[v] != v)
+      v = set[v] = set[set[v]];
+    return v;
+  };
+  for (auto e : order) {
+    auto from = int(std::upper_bound(snapshot.offsets.begin(), snapshot.offsets.end(), e) - snapshot.offsets.begin() - 1);
+    int a = root(from), b = root(int(snapshot.targets[e]));
+    if (a == b)
+      continue;
+    set[a] = b;
+    kruskal.push_back(e);
+  }
+
+  tinygraph::ThreadPool pool(3);
+  auto boruvka = tinygraph::minimum_spanning_forest(snapshot, pool);
+  std::sort(boruvka.begin(), boruvka.end());
+  std::sort(kruskal.begin(), kruskal.end());
+  ok = ok && boruvka == kruskal;
+
+  std::cout << "large example" << std::endl;
+  std::cout << "\t" << forest.edges.size() << " edges, total " << expected << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool overflow_example() {
+  auto city = tinygraph::typestore_add("city");
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto name : {"VIE", "BER", "PAR"})
+    g->add(name, city);
+  g->link("VIE", "BER", true)->insert({DISTANCE, 2000000000});
+  g->link("BER", "PAR", true)->insert({DISTANCE, 2000000000});
+
+  // the int total would overflow, so it carries on as double
+  auto forest = tinygraph::minimum_spanning_forest(*g, DISTANCE);
+  bool ok = forest.edges.size() == 2 && std::holds_alternative<double>(forest.total) &&
+            std::get<double>(forest.total) == 4000000000.0;
+
+  std::cout << "overflow example" << std::endl;
+  std::visit([](auto total) { std::cout << "\ttotal " << total << std::endl; }, forest.total);
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = network_example();
+  ok = large_example() && ok;
+  ok = overflow_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+#include <set>
+
+static constexpr char DISTANCE[] = "distance";
+
+void add_airports(tinygraph::Graph &g, const std::vector<std::tuple<std::string, std::string, int>> &links) {
+  auto airport = tinygraph::typestore_add("airport");
+
+  for (auto &[from, to, distance] : links) {
+    if (!g.vertex_exists(from))
+      g.add(from, airport);
+    if (!g.vertex_exists(to))
+      g.add(to, airport);
+  }
+  for (auto &[from, to, distance] : links) {
+    auto linkprops = g.link(from, to, false);
+    linkprops->insert({DISTANCE, distance});
+  }
+}
+
+std::set<std::set<std::string>> named_components(const tinygraph::Snapshot &snapshot, const tinygraph::Components &components) {
+  std::vector<std::set<std::string>> grouped(components.count);
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    if (components.component[v] < components.count)
+      grouped[components.component[v]].insert(snapshot.names[v]);
+  }
+  return {grouped.begin(), grouped.end()};
+}
+
+bool short_haul_example() {
+  std::vector<std::tuple<std::string, std::string, int>> links = {
+      {"PHX", "LAX", 596},   {"LAX", "PHX", 596},   {"PHX", "JFK", 3465},  {"JFK", "PHX", 3465},
+      {"JFK", "OKC", 2164},  {"OKC", "JFK", 2164},  {"JFK", "HEL", 6626},  {"HEL", "JFK", 6626},
+      {"MEX", "LAX", 2499},  {"LAX", "MEX", 2499},  {"MEX", "LIM", 4231},  {"LIM", "MEX", 4231},
+      {"VIE", "BER", 522},   {"BER", "VIE", 522},   {"LAP", "BER", 9947},  {"BER", "LAP", 9947}};
+
+  auto g = std::make_unique<tinygraph::Graph>();
+  add_airports(*g, links);
+
+  // the same subgraph, copied the old way
+  auto copy = std::make_unique<tinygraph::Graph>();
+  std::vector<std::tuple<std::string, std::string, int>> short_links;
+  for (auto &link : links) {
+    if (std::get<2>(link) < 5000)
+      short_links.push_back(link);
+  }
+  add_airports(*copy, short_links);
+
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  tinygraph::Snapshot copied(*copy, DISTANCE);
+
+  auto view = tinygraph::SubgraphView::where(
+      snapshot, [](const tinygraph::Vertex &) { return true; },
+      [](const tinygraph::Edge &edge) { return std::any_cast<int>(edge.properties->at(DISTANCE)) < 5000; });
+
+  bool ok = view.vertex_count() == snapshot.size();
+
+  auto expected = named_components(copied, tinygraph::strongly_connected_components(copied));
+  // vertices that lost all their edges are singletons in the view but absent from the copy
+  auto found = named_components(snapshot, tinygraph::strongly_connected_components(view));
+  for (auto &component : expected) {
+    ok = ok && found.count(component);
+  }
+  ok = ok && found.size() == expected.size() + 2;
+
+  auto on_view = tinygraph::dijkstra(view, snapshot.id("PHX"));
+  auto on_copy = tinygraph::dijkstra(copied, copied.id("PHX"));
+  tinygraph::ShortestPaths relaxed;
+  ok = ok && tinygraph::bellman_ford(view, snapshot.id("PHX"), relaxed);
+
+  for (std::size_t v = 0; v < copied.size(); v++) {
+    auto id = snapshot.id(copied.names[v]);
+    ok = ok && on_view.distance[id] == on_copy.distance[v] && relaxed.distance[id] == on_copy.distance[v];
+  }
+  ok = ok && on_view.distance[snapshot.id("HEL")] == std::numeric_limits<double>::infinity();
+
+  // one cluster, given by id
+  tinygraph::SubgraphView cluster(snapshot, {snapshot.id("VIE"), snapshot.id("BER"), snapshot.id("LAP")});
+  auto levels = tinygraph::bfs(cluster, snapshot.id("VIE"));
+  ok = ok && levels[snapshot.id("LAP")] == 2 && levels[snapshot.id("PHX")] == tinygraph::unreachable;
+
+  // components of a view that leaves most vertices out
+  tinygraph::SubgraphView pairs(snapshot, {snapshot.id("PHX"), snapshot.id("LAX"), snapshot.id("VIE"), snapshot.id("BER")});
+  auto paired = tinygraph::strongly_connected_components(pairs);
+  ok = ok && paired.count == 2 && paired.component[snapshot.id("JFK")] == SIZE_MAX;
+  ok = ok && named_components(snapshot, paired) == std::set<std::set<std::string>>{{"PHX", "LAX"}, {"VIE", "BER"}};
+
+  std::cout << "short haul example" << std::endl;
+  for (auto &component : found) {
+    std::cout << "\t{ ";
+    for (auto &name : component)
+      std::cout << name << " ";
+    std::cout << "}" << std::endl;
+  }
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return short_haul_example() ? 0 : 1;
+}
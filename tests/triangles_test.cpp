@@ -0,0 +1,114 @@
+#include "../tinygraph.h"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+
+bool friends_example() {
+  auto person = tinygraph::typestore_add("person");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  for (auto name : {"ann", "bob", "cid", "dan", "eve", "fay"}) {
+    g->add(name, person);
+  }
+
+  bool undirected = true;
+
+  // ann, bob, cid and dan form a 4-clique, eve hangs off dan, fay is alone
+  g->link("ann", "bob", undirected);
+  g->link("ann", "cid", undirected);
+  g->link("ann", "dan", undirected);
+  g->link("bob", "cid", undirected);
+  g->link("bob", "dan", undirected);
+  g->link("cid", "dan", undirected);
+  g->link("dan", "eve", undirected);
+
+  auto triangles = tinygraph::vertex_triangles(*g);
+  auto clustering = tinygraph::clustering_coefficients(*g);
+  auto cores = tinygraph::core_numbers(*g);
+  tinygraph::Snapshot snapshot(*g);
+
+  std::cout << "friends example" << std::endl;
+  for (auto &[name, count] : triangles) {
+    std::cout << "\t" << name << " : " << count << " triangles, clustering "
+              << clustering[name] << ", core " << cores[name] << std::endl;
+  }
+
+  bool ok = tinygraph::triangle_count(snapshot) == 4 && triangles["ann"] == 3 &&
+            triangles["dan"] == 3 && triangles["eve"] == 0 &&
+            std::abs(clustering["dan"] - 0.5) < 1e-12 && cores["ann"] == 3 &&
+            cores["dan"] == 3 && cores["eve"] == 1 && cores["fay"] == 0;
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool random_example() {
+  auto node = tinygraph::typestore_add("node");
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  constexpr int vertices = 400;
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> pick(0, vertices - 1);
+
+  for (int i = 0; i < vertices; i++) {
+    g->add(std::to_string(i), node);
+  }
+
+  std::set<std::pair<int, int>> edges;
+  for (int i = 0; i < 6000; i++) {
+    int a = pick(random), b = pick(random);
+    if (a == b)
+      continue;
+    edges.insert({std::min(a, b), std::max(a, b)});
+    g->link(std::to_string(a), std::to_string(b), true);
+  }
+
+  std::size_t brute = 0;
+  for (auto &[a, b] : edges) {
+    for (int c = b + 1; c < vertices; c++) {
+      if (edges.count({a, c}) && edges.count({b, c}))
+        brute++;
+    }
+  }
+
+  tinygraph::Snapshot snapshot(*g);
+  auto total = tinygraph::triangle_count(snapshot);
+
+  std::size_t summed = 0;
+  for (auto count : tinygraph::vertex_triangles(snapshot)) {
+    summed += count;
+  }
+
+  bool ok = total == brute && summed == 3 * brute;
+
+  // SIMD intersection against the scalar merge, on lists long enough to hit the
+  // vector blocks and the scalar tails.
+  for (int round = 0; round < 200 && ok; round++) {
+    std::set<std::uint32_t> a_set, b_set;
+    std::uniform_int_distribution<std::uint32_t> value(0, 300);
+    for (int i = 0; i < round; i++) {
+      a_set.insert(value(random));
+      b_set.insert(value(random));
+    }
+    std::vector<std::uint32_t> a(a_set.begin(), a_set.end());
+    std::vector<std::uint32_t> b(b_set.begin(), b_set.end());
+    ok = tinygraph::intersect_count(a.data(), a.size(), b.data(), b.size()) ==
+         tinygraph::intersect_count_scalar(a.data(), a.size(), b.data(), b.size());
+  }
+
+  std::cout << "random example" << std::endl;
+  std::cout << "\t" << total << " triangles" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = friends_example();
+  ok = random_example() && ok;
+  return ok ? 0 : 1;
+}
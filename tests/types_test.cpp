@@ -0,0 +1,71 @@
+#include "../tinygraph.h"
+#include <iostream>
+#include <memory>
+
+static constexpr char DISTANCE[] = "distance";
+
+bool travel_example() {
+  auto airport = tinygraph::typestore_add("airport");
+  auto station = tinygraph::typestore_add("station");
+
+  bool ok = tinygraph::typestore_add("airport") == airport &&
+            tinygraph::typestore_get("station") == station &&
+            tinygraph::typestore_get(airport->id) == airport &&
+            tinygraph::typestore_get("harbour") == nullptr;
+
+  auto g = std::make_unique<tinygraph::Graph>();
+
+  g->add("VIE", airport);
+  g->add("MUC", airport);
+  g->add("FRA", airport);
+  g->add("Wien Hbf", station);
+  g->add("Muenchen Hbf", station);
+
+  bool directed = false;
+  std::shared_ptr<std::map<std::string, std::any>> linkprops;
+
+  // by train VIE -> MUC is cheaper, but only through stations
+  linkprops = g->link("VIE", "Wien Hbf", directed);
+  linkprops->insert({DISTANCE, 20});
+  linkprops = g->link("Wien Hbf", "Muenchen Hbf", directed);
+  linkprops->insert({DISTANCE, 400});
+  linkprops = g->link("Muenchen Hbf", "MUC", directed);
+  linkprops->insert({DISTANCE, 40});
+  linkprops = g->link("VIE", "MUC", directed);
+  linkprops->insert({DISTANCE, 600});
+  linkprops = g->link("MUC", "FRA", directed);
+  linkprops->insert({DISTANCE, 300});
+
+  ok = ok && g->vertices_of(airport).size() == 3 && g->vertices_of(station).size() == 2;
+
+  std::cout << "travel example" << std::endl;
+
+  g->bellman_ford("VIE", DISTANCE);
+  auto any_path = g->find_shortest_path("FRA");
+  ok = ok && std::get<int>(g->distances["FRA"]) == 760;
+
+  g->bellman_ford("VIE", DISTANCE, {airport});
+  auto air_path = g->find_shortest_path("FRA");
+  ok = ok && std::get<int>(g->distances["FRA"]) == 900 && air_path.size() == 3 &&
+       std::get<int>(g->distances["Wien Hbf"]) == std::numeric_limits<int>::max();
+
+  for (auto &vertex : air_path) {
+    std::cout << "\t" << vertex << std::endl;
+  }
+
+  tinygraph::Snapshot snapshot(*g, DISTANCE);
+  tinygraph::TypeFilter only_airports(snapshot, {airport});
+  auto levels = tinygraph::bfs(snapshot, snapshot.id("VIE"), only_airports);
+  auto paths = tinygraph::dijkstra(snapshot, snapshot.id("VIE"), only_airports);
+
+  ok = ok && levels[snapshot.id("FRA")] == 2 && levels[snapshot.id("Muenchen Hbf")] == tinygraph::unreachable &&
+       paths.distance[snapshot.id("FRA")] == 900 && any_path.size() == 5;
+
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  return travel_example() ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include "../tinygraph.h"
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+static constexpr char WEIGHT[] = "weight";
+
+std::string name_of(std::size_t i) { return "v" + std::to_string(i); }
+
+bool concurrent_example() {
+  auto node = tinygraph::typestore_add("node");
+  const std::size_t vertices = 2000;
+
+  auto initial = std::make_unique<tinygraph::Graph>();
+  initial->add(name_of(0), node);
+  tinygraph::VersionedGraph versioned(std::move(initial), WEIGHT, 256);
+
+  auto expected = std::make_unique<tinygraph::Graph>();
+  expected->add(name_of(0), node);
+
+  auto before = versioned.pin();
+
+  std::atomic<bool> done{false};
+  std::atomic<bool> ok{true};
+  std::size_t queries = 0;
+
+  // queries on a pinned version must be repeatable whatever the writer does meanwhile
+  std::thread reader([&]() {
+    std::uint64_t last = 0;
+    while (!done) {
+      auto version = versioned.pin();
+      auto size = version->size();
+      auto first = tinygraph::dijkstra(*version, version->id(name_of(0)));
+      auto second = tinygraph::dijkstra(*version, version->id(name_of(0)));
+
+      if (version->epoch < last || version->size() != size || first.distance != second.distance)
+        ok = false;
+      last = version->epoch;
+      queries++;
+    }
+  });
+
+  for (std::size_t i = 1; i < vertices; i++) {
+    versioned.add(name_of(i), node);
+    expected->add(name_of(i), node);
+
+    std::map<std::string, std::any> properties = {{WEIGHT, int(i % 7 + 1)}};
+    versioned.link(name_of(i - 1), name_of(i), false, properties);
+    *expected->link(name_of(i - 1), name_of(i), false) = properties;
+
+    if (i % 3 == 0) {
+      versioned.link(name_of(i), name_of(i / 2), true, properties);
+      *expected->link(name_of(i), name_of(i / 2), true) = properties;
+    }
+    if (i % 100 == 0)
+      versioned.add_prop(name_of(i), "checkpoint", int(i));
+  }
+
+  done = true;
+  reader.join();
+
+  bool res = ok && before->size() == 1 && !versioned.add(name_of(1), node) && !versioned.link(name_of(1), "missing", false, {{WEIGHT, 1}});
+
+  auto version = versioned.pin();
+  tinygraph::Snapshot snapshot(*expected, WEIGHT);
+  auto on_version = tinygraph::dijkstra(*version, version->id(name_of(0)));
+  auto on_snapshot = tinygraph::dijkstra(snapshot, snapshot.id(name_of(0)));
+
+  res = res && version->size() == vertices;
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    res = res && on_version.distance[version->id(snapshot.names[v])] == on_snapshot.distance[v];
+  }
+
+  auto checkpoint = version->property(version->id(name_of(1900)), "checkpoint");
+  res = res && checkpoint && std::any_cast<int>(*checkpoint) == 1900;
+  res = res && !version->property(version->id(name_of(1901)), "checkpoint");
+
+  // merged or not, a version answers the same
+  versioned.merge();
+  auto merged = versioned.pin();
+  auto on_merged = tinygraph::dijkstra(*merged, merged->id(name_of(0)));
+  for (std::size_t v = 0; v < snapshot.size(); v++) {
+    res = res && on_merged.distance[merged->id(snapshot.names[v])] == on_snapshot.distance[v];
+  }
+
+  std::cout << "concurrent example" << std::endl;
+  std::cout << "\t" << queries << " queries during " << version->epoch << " versions" << std::endl;
+  std::cout << "\tv0 -> " << name_of(vertices - 1) << " = " << on_version.distance[version->id(name_of(vertices - 1))] << std::endl;
+  std::cout << (res ? "\tok" : "\tmismatch") << std::endl;
+  return res;
+}
+
+bool persistent_example() {
+  tinygraph::PersistentMap<std::string, int> before;
+  tinygraph::SharedLog<int> log;
+  for (int i = 0; i < 1000; i++) {
+    before.set(name_of(i), i);
+    log.push_back(i);
+  }
+
+  // later writes to a copy leave the original as it was, shared buffer or not
+  auto after = before;
+  auto longer = log, other = log;
+  after.set(name_of(5), -5);
+  after.set("new", 1);
+  longer.push_back(1000);
+  other.push_back(-1);
+
+  bool ok = before.size() == 1000 && after.size() == 1001 && *before.find(name_of(5)) == 5 && *after.find(name_of(5)) == -5;
+  ok = ok && !before.find("new") && *after.find("new") == 1 && *after.find(name_of(999)) == 999;
+  ok = ok && log.size() == 1000 && longer.size() == 1001 && other.size() == 1001;
+  ok = ok && longer[1000] == 1000 && other[1000] == -1 && log[999] == 999 && other[500] == 500;
+
+  std::cout << "persistent example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+bool merge_example() {
+  auto node = tinygraph::typestore_add("node");
+  tinygraph::VersionedGraph versioned(std::make_unique<tinygraph::Graph>(), WEIGHT, 8);
+
+  // merges run in the background while these writes go on; ids stay put through them
+  std::vector<std::size_t> ids;
+  for (std::size_t i = 0; i < 300; i++) {
+    versioned.add(name_of(i), node);
+    ids.push_back(versioned.pin()->id(name_of(i)));
+    if (i > 0) versioned.link(name_of(i), name_of(i - 1), true, {{WEIGHT, 2}});
+  }
+  versioned.add_prop(name_of(7), "mark", 7);
+  versioned.merge();
+
+  auto version = versioned.pin();
+  bool ok = version->size() == 300 && version->property(version->id(name_of(7)), "mark") && !version->property(version->id(name_of(8)), "mark");
+  for (std::size_t i = 0; i < 300; i++) ok = ok && version->id(name_of(i)) == ids[i] && version->name(ids[i]) == name_of(i);
+
+  auto paths = tinygraph::dijkstra(*version, version->id(name_of(0)));
+  ok = ok && paths.distance[version->id(name_of(299))] == 598;
+
+  std::cout << "merge example" << std::endl;
+  std::cout << (ok ? "\tok" : "\tmismatch") << std::endl;
+  return ok;
+}
+
+int main() {
+  tinygraph::typestore_init();
+  bool ok = concurrent_example();
+  ok = persistent_example() && ok;
+  ok = merge_example() && ok;
+  return ok ? 0 : 1;
+}
@@ -1,10 +1,34 @@
 #ifndef TINYGRAPH_TINYGRAPH_H
 #define TINYGRAPH_TINYGRAPH_H
 
+#include "data/builder.h"
+#include "data/compressed.h"
 #include "data/graph.h"
+#include "data/index.h"
+#include "data/persistent.h"
+#include "data/reachability.h"
+#include "data/shard.h"
+#include "data/snapshot.h"
+#include "data/subgraph.h"
 #include "data/types.h"
+#include "data/versioned.h"
 
+#include "functions/apsp.h"
+#include "functions/async.h"
+#include "functions/cancellation.h"
+#include "functions/components.h"
 #include "functions/connections.h"
+#include "functions/distributed.h"
+#include "functions/export.h"
+#include "functions/intersect.h"
+#include "functions/k_shortest.h"
+#include "functions/negative_cycle.h"
+#include "functions/parallel.h"
+#include "functions/pregel.h"
+#include "functions/spanning_tree.h"
+#include "functions/transport.h"
+#include "functions/traversal.h"
+#include "functions/triangles.h"
 
 #include "generators/data.h"
 
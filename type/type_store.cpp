@@ -8,18 +8,49 @@
 #include <utility>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace tinygraph {
-    std::map<const char*, std::shared_ptr<Type>> types;
+    // Types are interned: one Type per name, numbered in registration order.
+    std::vector<std::shared_ptr<Type>> types;
+    std::unordered_map<std::string, std::uint32_t> type_ids;
+    std::mutex types_mutex;
+
+    std::shared_ptr<Type> typestore_add(std::string type) {
+        std::lock_guard<std::mutex> lock(types_mutex);
+
+        auto existing = type_ids.find(type);
+        if (existing != type_ids.end()) return types[existing->second];
+
+        auto type_obj = std::make_shared<Type>(std::move(type), static_cast<std::uint32_t>(types.size()));
+        type_ids[type_obj->name] = type_obj->id;
+        types.push_back(type_obj);
+
+        return type_obj;
+    }
 
     void typestore_init() {
-        types["none"] = std::make_shared<Type>("none");
+        typestore_add("none");
     }
 
-    std::shared_ptr<Type> typestore_add(std::string type) {
-        auto type_obj = std::make_shared<Type>(std::move(type));
-        types[type_obj->name.c_str()] = type_obj;
+    std::shared_ptr<Type> typestore_get(const std::string& name) {
+        std::lock_guard<std::mutex> lock(types_mutex);
 
-        return type_obj;
+        auto existing = type_ids.find(name);
+        return existing == type_ids.end() ? nullptr : types[existing->second];
+    }
+
+    std::shared_ptr<Type> typestore_get(std::uint32_t id) {
+        std::lock_guard<std::mutex> lock(types_mutex);
+
+        return id < types.size() ? types[id] : nullptr;
+    }
+
+    std::size_t typestore_size() {
+        std::lock_guard<std::mutex> lock(types_mutex);
+
+        return types.size();
     }
 }
@@ -8,6 +8,9 @@
 namespace tinygraph {
     void typestore_init();
     std::shared_ptr<Type> typestore_add(std::string type);
+    std::shared_ptr<Type> typestore_get(const std::string& name);
+    std::shared_ptr<Type> typestore_get(std::uint32_t id);
+    std::size_t typestore_size();
 
 }
 